@@ -6,9 +6,15 @@
 
 #ifndef ASYNC_JSON_BASIC_JSON_PARSER_HPP_INCLUDED
 #define ASYNC_JSON_BASIC_JSON_PARSER_HPP_INCLUDED
-#include <cmath>
 #include <hsm/hsm.hpp>
+#include <cassert>
+#include <limits>
+#include <type_traits>
 #include <async_json/default_traits.hpp>
+#include <async_json/number_converter.hpp>
+#include <async_json/simd_scan.hpp>
+#include <async_json/string_converter.hpp>
+#include <async_json/structural_index.hpp>
 namespace async_json
 {
 namespace detail
@@ -32,6 +38,10 @@ constexpr hsm::event<struct f_char>          f;
 constexpr hsm::event<struct n_char>          n;
 constexpr hsm::event<struct esc_char>        escape;
 constexpr hsm::event<struct end_of_input>    eoi;
+constexpr hsm::event<struct skipped_value>   skipped;
+constexpr hsm::event<struct invalid_skipped> skipped_invalid;
+constexpr hsm::event<struct number_scanned>  number_run;
+constexpr hsm::event<struct keyword_scanned> keyword_run;
 
 constexpr hsm::state_ref<struct done_s>          done;
 constexpr hsm::state_ref<struct error_s>         error;
@@ -55,7 +65,7 @@ constexpr hsm::state_ref<struct name_n_cont_s>         name_n_cont;
 constexpr hsm::state_ref<struct name_n_cont_esc_s>     name_n_cont_esc;
 
 constexpr hsm::state_ref<struct int_number_s>      int_number_state;
-constexpr hsm::state_ref<struct int_number_ws_s>   int_number_ws;
+constexpr hsm::state_ref<struct int_number_minus_s> int_number_minus;
 constexpr hsm::state_ref<struct fraction_number_s> fraction_number;
 constexpr hsm::state_ref<struct exponent_sign_s>   exp_sign_state;
 constexpr hsm::state_ref<struct exponent_s>        exp_state;
@@ -67,6 +77,133 @@ constexpr hsm::state_ref<struct array_object_br_close_s>  array_object_br_close;
 constexpr hsm::state_ref<struct array_object_idx_close_s> array_object_idx_close;
 constexpr hsm::state_ref<struct array_object_s>           array_object;
 
+// Used directly as hsm event ids: hsm numbers the events handed to create_state_machine in order starting at 1, so the
+// enumerators follow the order of the character events in create_parser_sm. basic_json_parser checks that both agree.
+enum class char_class : uint8_t
+{
+    other = 1,
+    digit,
+    quot,
+    colon,
+    comma,
+    dot,
+    exponent,
+    plus,
+    minus,
+    br_open,
+    br_close,
+    idx_open,
+    idx_close,
+    whitespace,
+    t,
+    f,
+    n,
+    escape,
+    eoi
+};
+
+struct char_class_table
+{
+    char_class classes[256];
+    constexpr char_class_table() : classes{}
+    {
+        for (auto& c : classes) c = char_class::other;
+        for (char d = '0'; d <= '9'; ++d) set(d, char_class::digit);
+        set('n', char_class::n);
+        set('t', char_class::t);
+        set('f', char_class::f);
+        set('{', char_class::br_open);
+        set('}', char_class::br_close);
+        set('[', char_class::idx_open);
+        set(']', char_class::idx_close);
+        set('"', char_class::quot);
+        set(':', char_class::colon);
+        set(',', char_class::comma);
+        set('+', char_class::plus);
+        set('-', char_class::minus);
+        set('\\', char_class::escape);
+        set('E', char_class::exponent);
+        set('e', char_class::exponent);
+        set('.', char_class::dot);
+        for (char w : {' ', '\b', '\t', '\r', '\n'}) set(w, char_class::whitespace);
+    }
+    constexpr void       set(char c, char_class cc) noexcept { classes[static_cast<uint8_t>(c)] = cc; }
+    constexpr char_class operator[](char c) const noexcept { return classes[static_cast<uint8_t>(c)]; }
+};
+
+constexpr char_class_table char_classes{};
+
+template <typename Traits, typename = void>
+struct integer_overflow_policy : std::integral_constant<overflow_policy, overflow_policy::promote_to_float>
+{
+};
+
+template <typename Traits>
+struct integer_overflow_policy<Traits, std::void_t<decltype(Traits::integer_overflow_policy)>>
+    : std::integral_constant<overflow_policy, Traits::integer_overflow_policy>
+{
+};
+
+template <typename Traits, typename = void>
+struct uses_raw_numbers : std::false_type
+{
+};
+
+template <typename Traits>
+struct uses_raw_numbers<Traits, std::void_t<decltype(Traits::raw_numbers)>> : std::bool_constant<Traits::raw_numbers>
+{
+};
+
+template <typename Traits, typename = void>
+struct uses_structural_index : std::false_type
+{
+};
+
+template <typename Traits>
+struct uses_structural_index<Traits, std::void_t<decltype(Traits::structural_index)>> : std::bool_constant<Traits::structural_index>
+{
+};
+
+template <typename Traits, typename = void>
+struct uses_contiguous_strings : std::false_type
+{
+};
+
+template <typename Traits>
+struct uses_contiguous_strings<Traits, std::void_t<decltype(Traits::contiguous_strings)>> : std::bool_constant<Traits::contiguous_strings>
+{
+};
+
+template <typename Traits, typename = void>
+struct uses_decode_escapes : std::false_type
+{
+};
+
+template <typename Traits>
+struct uses_decode_escapes<Traits, std::void_t<decltype(Traits::decode_escapes)>> : std::bool_constant<Traits::decode_escapes>
+{
+};
+
+template <typename Handler, typename = void>
+struct has_chunk_end : std::false_type
+{
+};
+
+template <typename Handler>
+struct has_chunk_end<Handler, std::void_t<decltype(std::declval<Handler&>().chunk_end())>> : std::true_type
+{
+};
+
+template <typename Handler, typename = void>
+struct has_reset : std::false_type
+{
+};
+
+template <typename Handler>
+struct has_reset<Handler, std::void_t<decltype(std::declval<Handler&>().reset())>> : std::true_type
+{
+};
+
 template <error_cause err, typename S>
 constexpr auto error_action()
 {
@@ -85,6 +222,7 @@ struct default_handler
     void value(integer_t) {}
     void value(float_t) {}
     void value(sv_t const&) {}
+    void number_value(sv_t const&) {}
     void string_value_start(sv_t const&) {}
     void string_value_cont(sv_t const&) {}
     void string_value_end() {}
@@ -99,14 +237,28 @@ struct default_handler
     void error(error_cause) {}
 };
 
-template <typename Handler = default_handler<default_traits>, typename Traits = default_traits>
-struct basic_json_parser
+namespace detail
+{
+struct string_sink
+{
+    std::string text;
+    void        operator()(char const* data, size_t size) { text.append(data, size); }
+};
+
+/// context of the parser state machine: handler, partial values and the nesting stack
+template <typename Handler, typename Traits>
+struct parser_state
 {
     using float_t   = typename Traits::float_t;
     using integer_t = typename Traits::integer_t;
     using sv_t      = typename Traits::sv_t;
 
-   private:
+    static constexpr overflow_policy on_integer_overflow = integer_overflow_policy<Traits>::value;
+    static constexpr bool            raw_numbers         = uses_raw_numbers<Traits>::value;
+    static constexpr bool            structural_index    = uses_structural_index<Traits>::value;
+    static constexpr bool            contiguous_strings  = uses_contiguous_strings<Traits>::value;
+    static constexpr bool            decode_escapes      = uses_decode_escapes<Traits>::value;
+
     Handler cbs;
 
     size_t byte_count{0};
@@ -121,385 +273,842 @@ struct basic_json_parser
     keyword_receive kw_state;
     sv_t            parsed_view;
     sv_t            current_input_buffer;
+    size_t          input_pos{0};
+
+    int                num_sign{1};
+    int                exp_sign{1};
+    int                sig_digits{0};        // significant digits of the number
+    long               decimal_exponent{0};  // decimal exponent of the significant digits, decremented by fraction digits
+    unsigned long long exp_number{0};
+    unsigned long long int_number{0};  // significant digits, as long as there are at most max_mantissa_digits
+    std::string        digit_buffer;   // all significant digits, once there are more than int_number can hold
+                                       // or with raw_numbers the text of a number that started in a previous input buffer
+    size_t             number_start{0};  // input_pos of the first character of the number
+    std::string        spill;            // with contiguous_strings the part of a string or name in previous input buffers
+    bool               escaped{false};   // the current string or name has an escape sequence
+
+    json_unescaper<string_sink> unescaper;  // with decode_escapes holds the decoded text of the current fragment
 
-    int                  num_sign{1};
-    int                  exp_sign{1};
-    int                  frac_digits{0};
-    unsigned long long   exp_number{0};
-    unsigned long long   int_number{0};
-    unsigned long long   fraction{0};
     std::vector<uint8_t> state_stack;
-    using self_t = basic_json_parser<Handler, Traits>;
-    std::function<bool(sv_t const&, int, self_t&)> process_events;
 
-   private:
-    float_t get_fraction_we()
+    enum class skip_mode : uint8_t
     {
-        float_t ret = get_fraction() * static_cast<float_t>(std::pow(10, exp_sign * static_cast<integer_t>(exp_number)));
-        exp_number  = 0;
-        exp_sign    = 1;
-        return ret;
+        none,
+        pending_value,  // skip the value of the member once the colon is seen
+        value,          // skip until skipper finds the end of the string, object or array
+        scalar,         // check the number or keyword up to the next delimiter with scalar_skipper
+        container       // skip until skipper finds the end of the current object or array
     };
+    skip_mode      skipping{skip_mode::none};
+    skip_scanner   skipper;
+    scalar_scanner scalar_skipper;
+    scalar_scanner run;         // with structural_index the number or keyword handed to the state machine as one event
+    size_t         run_end{0};  // input_pos behind it
+
+    parser_state() = default;
+    explicit parser_state(Handler&& handler) : cbs(std::move(handler)) {}
+
+    Handler* callback_handler() { return &cbs; }
+
+    /// invokes a handler callback that may return a parse_verdict
+    template <typename Callback>
+    void with_verdict(Callback&& callback, skip_mode on_skip)
+    {
+        if constexpr (std::is_same_v<std::invoke_result_t<Callback>, parse_verdict>)
+        {
+            if (callback() == parse_verdict::skip)
+            {
+                skipping = on_skip;
+                if (on_skip == skip_mode::container) skipper = skip_scanner{1, false, false};
+            }
+        }
+        else
+            callback();
+    }
+
+    void begin_number()
+    {
+        number_start = input_pos;
+        if (cur != '-') add_digit(cur);
+    }
+
+    void add_digit(char c)
+    {
+        if constexpr (raw_numbers) return;
+        if (sig_digits < max_mantissa_digits)
+        {
+            int_number = int_number * 10 + static_cast<unsigned>(c - '0');
+            sig_digits += int_number != 0;  // leading zeros are not significant
+            return;
+        }
+        if (digit_buffer.empty()) spill_digits();
+        digit_buffer.push_back(c);
+        ++sig_digits;
+    }
+
+    /// consumes the number that run checked up to run_end the way the number states do byte by byte
+    void add_number_run()
+    {
+        char const* it  = current_input_buffer.data() + input_pos;
+        char const* end = current_input_buffer.data() + run_end;
+        begin_number();
+        if (*it == '-') num_sign = -1;
+        for (++it; it != end && *it >= '0' && *it <= '9'; ++it) add_digit(*it);
+        if (it != end && *it == '.')
+            for (++it; it != end && *it >= '0' && *it <= '9'; ++it) add_digit(*it), --decimal_exponent;
+        if (it == end) return;
+        // the exponent marker is followed by at least a sign or a digit
+        if (*++it == '-') exp_sign = -1;
+        if (*it == '-' || *it == '+') ++it;
+        for (; it != end; ++it) add_exponent_digit(*it);
+    }
+
+    void spill_digits()
+    {
+        char buffer[24];
+        digit_buffer.assign(buffer, std::to_chars(buffer, buffer + sizeof buffer, int_number).ptr);
+    }
+
+    void add_exponent_digit(char c)
+    {
+        if constexpr (raw_numbers) return;
+        // anything beyond this is an overflow or underflow of every float type anyway
+        if (exp_number < 100000000) exp_number = exp_number * 10 + static_cast<unsigned>(c - '0');
+    }
+
+    void reset_number()
+    {
+        num_sign         = 1;
+        exp_sign         = 1;
+        sig_digits       = 0;
+        decimal_exponent = 0;
+        exp_number       = 0;
+        int_number       = 0;
+        digit_buffer.clear();
+    }
+
+    /// absolute value of the integer, false if it exceeds unsigned long long
+    bool integer_magnitude(unsigned long long& magnitude) const
+    {
+        magnitude = int_number;
+        // only a 20 digit number may still fit, from_chars reports everything above as out of range
+        return digit_buffer.empty() ||
+               std::from_chars(digit_buffer.data(), digit_buffer.data() + digit_buffer.size(), magnitude).ec == std::errc{};
+    }
+
+    bool integer_fits() const
+    {
+        using limits = std::numeric_limits<integer_t>;
+        unsigned long long magnitude;
+        auto const         max = static_cast<unsigned long long>(limits::max());
+        return integer_magnitude(magnitude) && magnitude <= (num_sign > 0 ? max : limits::is_signed ? max + 1 : 0);
+    }
 
     integer_t get_number()
     {
-        integer_t ret = num_sign * static_cast<integer_t>(int_number);
-        int_number    = 0;
-        num_sign      = 1;
+        unsigned long long magnitude;
+        integer_magnitude(magnitude);
+        integer_t ret = num_sign < 0 ? static_cast<integer_t>(0 - magnitude) : static_cast<integer_t>(magnitude);
+        reset_number();
         return ret;
-    };
-    float_t get_fraction()
+    }
+
+    /// keeps the part of the number that is in the current input buffer before it ends
+    void carry_number()
     {
-        float_t ret = num_sign * (static_cast<integer_t>(int_number) +
-                                  static_cast<float_t>(fraction) / static_cast<float_t>(std::pow(10, frac_digits)));
-        int_number  = 0;
-        num_sign    = 1;
-        fraction    = 0;
-        frac_digits = 0;
-        return ret;
-    };
-    void setup_sm()
+        if constexpr (!raw_numbers) return;
+        digit_buffer.append(current_input_buffer.data() + number_start, input_pos - number_start);
+        number_start = 0;
+    }
+
+    /// text of the number ending before the current character, valid until the next reset_number
+    sv_t number_text()
     {
-        using namespace hsm::literals;
-        auto kw_consume = [](self_t& self) {
-            return self.cur == self.kw_state.kw[self.kw_state.pos] && 0 != self.kw_state.kw[self.kw_state.pos + 1];
-        };
-        auto setup_true  = [](self_t& self) { self.kw_state = keyword_receive{"true", 1}; };
-        auto setup_false = [](self_t& self) { self.kw_state = keyword_receive{"false", 1}; };
-        auto setup_null  = [](self_t& self) { self.kw_state = keyword_receive{"null", 1}; };
-        auto kw_complete = [](self_t& self) {
-            return self.cur == self.kw_state.kw[self.kw_state.pos] && 0 == self.kw_state.kw[self.kw_state.pos + 1];
-        };
-        auto kw_wrong_char       = [](self_t& self) { return self.cur != self.kw_state.kw[self.kw_state.pos]; };
-        auto kw_consume_char     = [](self_t& self) { ++self.kw_state.pos; };
-        auto kw_complete_keyword = [](self_t& self) {
-            if (self.kw_state.kw == sv_t{"null"})
-                self.cbs.value(nullptr);
-            else if (self.kw_state.kw == sv_t{"true"})
-                self.cbs.value(true);
-            else
-                self.cbs.value(false);
-        };
+        auto const begin = current_input_buffer.data() + number_start;
+        if (digit_buffer.empty()) return sv_t(begin, input_pos - number_start);
+        digit_buffer.append(begin, input_pos - number_start);
+        return sv_t(digit_buffer.data(), digit_buffer.size());
+    }
 
-        auto negate_exp         = [](self_t& self) { self.exp_sign = -1; };
-        auto negate_num         = [](self_t& self) { self.num_sign = -1; };
-        auto add_digit_num      = [](self_t& self) { self.int_number = self.int_number * 10 + (self.cur - '0'); };
-        auto add_digit_exp      = [](self_t& self) { self.exp_number = self.exp_number * 10 + (self.cur - '0'); };
-        auto add_digit_fraction = [](self_t& self) { ++self.frac_digits, self.fraction = self.fraction * 10 + (self.cur - '0'); };
-
-        auto emit_number       = [](self_t& self) { self.cbs.value(self.get_number()); };
-        auto emit_fraction     = [](self_t& self) { self.cbs.value(self.get_fraction()); };
-        auto emit_exp_fraction = [](self_t& self) { self.cbs.value(self.get_fraction_we()); };
-        auto push_object       = [](self_t& self) {
-            self.cbs.object_start();
-            self.state_stack.push_back(0);
-        };
-        auto pop_object = [](self_t& self) {
-            self.cbs.object_end();
-            self.state_stack.pop_back();
-        };
-        auto push_array = [](self_t& self) {
-            self.cbs.array_start();
-            self.state_stack.push_back(1);
-        };
-        auto pop_array = [](self_t& self) {
-            self.cbs.array_end();
-            self.state_stack.pop_back();
-        };
-        auto emit_name_first = [](self_t& self) {
-            self.cbs.named_object_start(self.parsed_view);
-            self.parsed_view = sv_t(nullptr, 0);
-        };
+    /// decimal text of the integer, valid until the next reset_number
+    sv_t integer_text()
+    {
+        if (digit_buffer.empty()) spill_digits();
+        if (num_sign < 0) digit_buffer.insert(digit_buffer.begin(), '-');
+        return sv_t(digit_buffer.data(), digit_buffer.size());
+    }
 
-        auto emit_name_first_last = [](self_t& self) {
-            self.cbs.named_object(self.parsed_view);
-            self.parsed_view = sv_t(nullptr, 0);
-        };
+    float_t get_float()
+    {
+        long const    exp10 = exp_sign * static_cast<long>(exp_number) + decimal_exponent;
+        float_t const ret   = digit_buffer.empty() ? decimal_to_float<float_t>(int_number, exp10)  //
+                                                 : decimal_to_float<float_t>(digit_buffer, exp10);
+        bool const negative = num_sign < 0;
+        reset_number();
+        return negative ? -ret : ret;
+    }
 
-        auto emit_name_n = [](self_t& self) {
-            if (self.parsed_view.size()) self.cbs.named_object_cont(self.parsed_view);
-            self.parsed_view = sv_t(nullptr, 0);
-        };
+    void reset()
+    {
+        state_stack.clear();
+        skipping = skip_mode::none;
+        reset_number();
+        spill.clear();
+        escaped = false;
+        unescaper.reset();
+        byte_count = 0;
+    }
 
-        auto emit_name_n_last = [](self_t& self) {
-            if (self.parsed_view.size()) self.cbs.named_object_cont(self.parsed_view);
-            self.parsed_view = sv_t(nullptr, 0);
-            self.cbs.named_object_end();
-        };
+    /// with decode_escapes the decoded text of a fragment of the current string or name, last marks its final fragment
+    sv_t decoded(sv_t const& fragment, bool last)
+    {
+        if constexpr (decode_escapes)
+        {
+            if (!escaped) return fragment;
+            escaped = !last;
+            auto& text = unescaper.sink().text;
+            text.clear();
+            unescaper.feed(std::string_view(fragment.data(), fragment.size()));
+            if (last) unescaper.finish();
+            return sv_t(text.data(), text.size());
+        }
+        else
+            return fragment;
+    }
 
-        auto emit_str_first = [](self_t& self) {
-            self.cbs.string_value_start(self.parsed_view);
-            self.parsed_view = sv_t(nullptr, 0);
-        };
+    /// with contiguous_strings keeps the part of a string or name that ends with the input buffer
+    bool spill_parsed_view()
+    {
+        if constexpr (contiguous_strings)
+        {
+            spill.append(parsed_view.data(), parsed_view.size());
+            parsed_view = sv_t(nullptr, 0);
+            return true;
+        }
+        else
+            return false;
+    }
+    /// the complete string or name once the last part is spilled as well
+    sv_t spilled_view()
+    {
+        spill_parsed_view();
+        return sv_t(spill.data(), spill.size());
+    }
+};
 
-        auto emit_str_first_last = [](self_t& self) {
-            self.cbs.value(self.parsed_view);
-            self.parsed_view = sv_t(nullptr, 0);
-        };
+/// creates the character level parser state machine, the caller has to start it with a State instance
+template <typename State>
+auto create_parser_sm()
+{
+    using self_t          = State;
+    using sv_t            = typename State::sv_t;
+    using keyword_receive = typename State::keyword_receive;
+    using namespace hsm::literals;
+    auto kw_consume = [](self_t& self) {
+        return self.cur == self.kw_state.kw[self.kw_state.pos] && 0 != self.kw_state.kw[self.kw_state.pos + 1];
+    };
+    auto setup_true  = [](self_t& self) { self.kw_state = keyword_receive{"true", 1}; };
+    auto setup_false = [](self_t& self) { self.kw_state = keyword_receive{"false", 1}; };
+    auto setup_null  = [](self_t& self) { self.kw_state = keyword_receive{"null", 1}; };
+    auto kw_complete = [](self_t& self) {
+        return self.cur == self.kw_state.kw[self.kw_state.pos] && 0 == self.kw_state.kw[self.kw_state.pos + 1];
+    };
+    auto kw_wrong_char       = [](self_t& self) { return self.cur != self.kw_state.kw[self.kw_state.pos]; };
+    auto kw_consume_char     = [](self_t& self) { ++self.kw_state.pos; };
+    auto kw_complete_keyword = [](self_t& self) {
+        if (self.kw_state.kw == sv_t{"null"})
+            self.cbs.value(nullptr);
+        else if (self.kw_state.kw == sv_t{"true"})
+            self.cbs.value(true);
+        else
+            self.cbs.value(false);
+    };
 
-        auto emit_str_n = [](self_t& self) {
-            if (self.parsed_view.size()) self.cbs.string_value_cont(self.parsed_view);
-            self.parsed_view = sv_t(nullptr, 0);
-        };
+    // with structural_index numbers and keywords that end in the input buffer arrive checked and as a whole
+    auto run_is_integer   = [](self_t& self) { return self.run.at == scalar_scanner::stage::integer; };
+    auto run_is_fraction  = [](self_t& self) { return self.run.at == scalar_scanner::stage::fraction; };
+    auto add_number_run   = [](self_t& self) { self.add_number_run(); };
+    auto emit_keyword_run = [kw_complete_keyword](self_t& self) {
+        self.kw_state = keyword_receive{self.cur == 't' ? "true" : self.cur == 'f' ? "false" : "null", 0};
+        kw_complete_keyword(self);
+    };
 
-        auto emit_str_n_last = [](self_t& self) {
-            if (self.parsed_view.size()) self.cbs.string_value_cont(self.parsed_view);
-            self.parsed_view = sv_t(nullptr, 0);
-            self.cbs.string_value_end();
-        };
+    auto negate_exp         = [](self_t& self) { self.exp_sign = -1; };
+    auto negate_num         = [](self_t& self) { self.begin_number(), self.num_sign = -1; };
+    auto begin_number       = [](self_t& self) { self.begin_number(); };
+    auto add_digit_num      = [](self_t& self) { self.add_digit(self.cur); };
+    auto add_digit_exp      = [](self_t& self) { self.add_exponent_digit(self.cur); };
+    auto add_digit_fraction = [](self_t& self) { self.add_digit(self.cur), --self.decimal_exponent; };
 
-        auto stack_empty        = [](self_t& self) { return self.state_stack.size() == 0; };
-        auto no_object_on_stack = [](self_t& self) { return self.state_stack.size() == 0 || self.state_stack.back() != 0; };
-        auto object_on_stack    = [](self_t& self) { return self.state_stack.size() && self.state_stack.back() == 0; };
-        auto no_array_on_stack  = [](self_t& self) { return self.state_stack.size() == 0 || self.state_stack.back() != 1; };
-        auto array_on_stack     = [](self_t& self) { return self.state_stack.size() && self.state_stack.back() == 1; };
-        auto mem_start_str      = [](self_t& self) { self.parsed_view = sv_t(self.current_input_buffer.begin() + 1, 0); };
-        auto mem_n_str          = [](self_t& self) { self.parsed_view = sv_t(self.current_input_buffer.begin(), 1); };
-        auto mem_add_ch         = [](self_t& self) { self.parsed_view = sv_t(self.parsed_view.begin(), self.parsed_view.size() + 1); };
+    auto carry_number     = [](self_t& self) { self.carry_number(); };
+    auto integer_in_range = [](self_t& self) {
+        return self_t::raw_numbers || self_t::on_integer_overflow != overflow_policy::error || self.integer_fits();
+    };
+    // generic, so handlers only need number_value when they get to see it
+    auto emit_raw_number = [](auto& self) {
+        self.cbs.number_value(self.number_text());
+        self.reset_number();
+    };
+    auto emit_number = [emit_raw_number](self_t& self) {
+        if constexpr (self_t::raw_numbers)
+            emit_raw_number(self);
+        else if (self.integer_fits())
+            self.cbs.value(self.get_number());
+        else if constexpr (self_t::on_integer_overflow == overflow_policy::raw_text)
+        {
+            self.cbs.number_value(self.integer_text());
+            self.reset_number();
+        }
+        else
+            self.cbs.value(self.get_float());
+    };
+    auto emit_float = [emit_raw_number](self_t& self) {
+        if constexpr (self_t::raw_numbers)
+            emit_raw_number(self);
+        else
+            self.cbs.value(self.get_float());
+    };
+    using skip_mode  = typename State::skip_mode;
+    auto push_object = [](self_t& self) {
+        self.state_stack.push_back(0);
+        self.with_verdict([&self] { return self.cbs.object_start(); }, skip_mode::container);
+    };
+    auto pop_object = [](self_t& self) {
+        self.cbs.object_end();
+        self.state_stack.pop_back();
+    };
+    auto push_array = [](self_t& self) {
+        self.state_stack.push_back(1);
+        self.with_verdict([&self] { return self.cbs.array_start(); }, skip_mode::container);
+    };
+    auto pop_array = [](self_t& self) {
+        self.cbs.array_end();
+        self.state_stack.pop_back();
+    };
+    auto emit_name_first = [](self_t& self) {
+        if (self.spill_parsed_view()) return;
+        self.with_verdict([&self] { return self.cbs.named_object_start(self.decoded(self.parsed_view, false)); }, skip_mode::pending_value);
+        self.parsed_view = sv_t(nullptr, 0);
+    };
 
-        using namespace async_json::detail;
-        auto sm = hsm::create_state_machine<self_t>(  //
-            ch,                                       // catch all event
-            done,
-            error,                                      //
-            hsm::initial = json_state,                  //
-            json_state(                                 //
-                whitespace            = hsm::internal,  //
-                n / setup_null        = keyword,
-                f / setup_false       = keyword,              //
-                t / setup_true        = keyword,              //
-                br_open / push_object = member,               //
-                idx_open / push_array = json_state_in_array,  //
-                quot / mem_start_str  = string_start_cont,    //
-                digit / add_digit_num = int_number_state,     //
-                minus / negate_num    = int_number_ws,        //
-                eoi                   = hsm::internal,        //
-                json_state_in_array(                          //
-                    idx_close / pop_array = array_object),    //
-                hsm::any / detail::error_action<unexpected_character, self_t>() = error),
-            int_number_state(                                                                        //
-                int_number_ws(                                                                       //
-                    whitespace            = hsm::internal,                                           //
-                    digit / add_digit_num = int_number_state),                                       //
-                digit / add_digit_num                                     = hsm::internal,           //
-                dot                                                       = fraction_number,         //
-                exponent                                                  = exp_sign_state,          //
-                comma / emit_number                                       = array_object_comma,      //
-                br_close / emit_number                                    = array_object_br_close,   //
-                idx_close / emit_number                                   = array_object_idx_close,  //
-                whitespace / emit_number                                  = array_object,            //
-                eoi                                                       = hsm::internal,           //
-                hsm::any / detail::error_action<invalid_number, self_t>() = error),
-            fraction_number(                                                                         //
-                digit / add_digit_fraction                                = hsm::internal,           //
-                exponent                                                  = exp_sign_state,          //
-                comma / emit_fraction                                     = array_object_comma,      //
-                br_close / emit_fraction                                  = array_object_br_close,   //
-                idx_close / emit_fraction                                 = array_object_idx_close,  //
-                whitespace / emit_fraction                                = array_object,            //
-                eoi                                                       = hsm::internal,           //
-                hsm::any / detail::error_action<invalid_number, self_t>() = error),
-            exp_state(                                                                          //
-                digit / add_digit_exp = hsm::internal,                                          //
-                exp_sign_state(                                                                 //
-                    minus / negate_exp                                        = exp_state,      //
-                    plus / negate_exp                                         = exp_state,      //
-                    digit / add_digit_exp                                     = exp_state,      //
-                    eoi                                                       = hsm::internal,  //
-                    hsm::any / detail::error_action<invalid_number, self_t>() = error),
-                comma / emit_exp_fraction                                 = array_object_comma,      //
-                br_close / emit_exp_fraction                              = array_object_br_close,   //
-                idx_close / emit_exp_fraction                             = array_object_idx_close,  //
-                whitespace / emit_exp_fraction                            = array_object,            //
-                eoi                                                       = hsm::internal,           //
+    auto emit_name_first_last = [](self_t& self) {
+        self.with_verdict([&self] { return self.cbs.named_object(self.decoded(self.parsed_view, true)); }, skip_mode::pending_value);
+        self.parsed_view = sv_t(nullptr, 0);
+    };
+
+    auto emit_name_n = [](self_t& self) {
+        if (self.spill_parsed_view()) return;
+        auto const name = self.decoded(self.parsed_view, false);
+        if (name.size()) self.with_verdict([&self, &name] { return self.cbs.named_object_cont(name); }, skip_mode::pending_value);
+        self.parsed_view = sv_t(nullptr, 0);
+    };
+
+    auto emit_name_n_last = [](self_t& self) {
+        if constexpr (self_t::contiguous_strings)
+        {
+            self.with_verdict([&self] { return self.cbs.named_object(self.decoded(self.spilled_view(), true)); }, skip_mode::pending_value);
+            self.spill.clear();
+            return;
+        }
+        auto const name = self.decoded(self.parsed_view, true);
+        if (name.size()) self.with_verdict([&self, &name] { return self.cbs.named_object_cont(name); }, skip_mode::pending_value);
+        self.parsed_view = sv_t(nullptr, 0);
+        self.with_verdict([&self] { return self.cbs.named_object_end(); }, skip_mode::pending_value);
+    };
+
+    auto emit_str_first = [](self_t& self) {
+        if (self.spill_parsed_view()) return;
+        self.cbs.string_value_start(self.decoded(self.parsed_view, false));
+        self.parsed_view = sv_t(nullptr, 0);
+    };
+
+    auto emit_str_first_last = [](self_t& self) {
+        self.cbs.value(self.decoded(self.parsed_view, true));
+        self.parsed_view = sv_t(nullptr, 0);
+    };
+
+    auto emit_str_n = [](self_t& self) {
+        if (self.spill_parsed_view()) return;
+        auto const str = self.decoded(self.parsed_view, false);
+        if (str.size()) self.cbs.string_value_cont(str);
+        self.parsed_view = sv_t(nullptr, 0);
+    };
+
+    auto emit_str_n_last = [](self_t& self) {
+        if constexpr (self_t::contiguous_strings)
+        {
+            self.cbs.value(self.decoded(self.spilled_view(), true));
+            self.spill.clear();
+            return;
+        }
+        auto const str = self.decoded(self.parsed_view, true);
+        if (str.size()) self.cbs.string_value_cont(str);
+        self.parsed_view = sv_t(nullptr, 0);
+        self.cbs.string_value_end();
+    };
+
+    auto stack_empty        = [](self_t& self) { return self.state_stack.size() == 0; };
+    auto no_object_on_stack = [](self_t& self) { return self.state_stack.size() == 0 || self.state_stack.back() != 0; };
+    auto object_on_stack    = [](self_t& self) { return self.state_stack.size() && self.state_stack.back() == 0; };
+    auto no_array_on_stack  = [](self_t& self) { return self.state_stack.size() == 0 || self.state_stack.back() != 1; };
+    auto array_on_stack     = [](self_t& self) { return self.state_stack.size() && self.state_stack.back() == 1; };
+    auto mem_start_str      = [](self_t& self) { self.parsed_view = sv_t(self.current_input_buffer.data() + self.input_pos + 1, 0); };
+    auto mem_n_str          = [](self_t& self) { self.parsed_view = sv_t(self.current_input_buffer.data() + self.input_pos, 1); };
+    auto mem_add_ch         = [](self_t& self) { self.parsed_view = sv_t(self.parsed_view.begin(), self.parsed_view.size() + 1); };
+    auto mem_add_esc        = [](self_t& self) {
+        self.escaped     = true;
+        self.parsed_view = sv_t(self.parsed_view.begin(), self.parsed_view.size() + 1);
+    };
+    auto mem_n_esc          = [](self_t& self) {
+        self.escaped     = true;
+        self.parsed_view = sv_t(self.current_input_buffer.data() + self.input_pos, 1);
+    };
+
+    return hsm::create_state_machine<self_t>(  //
+        ch,                                    // catch all event, the order defines char_class
+        digit, quot, colon, comma, dot, exponent, plus, minus, br_open, br_close, idx_open, idx_close, whitespace, t, f, n, escape,
+        eoi, skipped, skipped_invalid, number_run, keyword_run,  //
+        done,
+        error,                                      //
+        hsm::initial = json_state,                  //
+        json_state(                                 //
+            whitespace            = hsm::internal,  //
+            n / setup_null        = keyword,
+            f / setup_false       = keyword,              //
+            t / setup_true        = keyword,              //
+            br_open / push_object = member,               //
+            idx_open / push_array = json_state_in_array,  //
+            quot / mem_start_str  = string_start_cont,    //
+            digit / begin_number  = int_number_state,     //
+            minus / negate_num    = int_number_minus,     //
+            eoi                   = hsm::internal,        //
+            skipped               = array_object,         //
+            skipped_invalid       = error,                //
+            number_run[run_is_integer] / add_number_run  = int_number_state,  //
+            number_run[run_is_fraction] / add_number_run = fraction_number,   //
+            number_run / add_number_run                  = exp_state,         //
+            keyword_run / emit_keyword_run               = array_object,      //
+            json_state_in_array(                          //
+                idx_close / pop_array = array_object),    //
+            hsm::any / detail::error_action<unexpected_character, self_t>() = error),
+        int_number_state(                                                                        //
+            int_number_minus(                                                                    //
+                digit / add_digit_num                                     = int_number_state,    //
+                eoi / carry_number                                        = hsm::internal,       //
+                hsm::any / detail::error_action<invalid_number, self_t>() = error),              //
+            digit / add_digit_num                                                     = hsm::internal,           //
+            dot                                                                       = fraction_number,         //
+            exponent                                                                  = exp_sign_state,          //
+            comma[integer_in_range] / emit_number                                     = array_object_comma,      //
+            br_close[integer_in_range] / emit_number                                  = array_object_br_close,   //
+            idx_close[integer_in_range] / emit_number                                 = array_object_idx_close,  //
+            whitespace[integer_in_range] / emit_number                                = array_object,            //
+            eoi / carry_number                                                        = hsm::internal,           //
+            hsm::any[integer_in_range] / detail::error_action<invalid_number, self_t>() = error,                  //
+            hsm::any / detail::error_action<integer_overflow, self_t>()               = error),
+        fraction_number(                                                                         //
+            digit / add_digit_fraction                                = hsm::internal,           //
+            exponent                                                  = exp_sign_state,          //
+            comma / emit_float                                        = array_object_comma,      //
+            br_close / emit_float                                     = array_object_br_close,   //
+            idx_close / emit_float                                    = array_object_idx_close,  //
+            whitespace / emit_float                                   = array_object,            //
+            eoi / carry_number                                        = hsm::internal,           //
+            hsm::any / detail::error_action<invalid_number, self_t>() = error),
+        exp_state(                                                                          //
+            digit / add_digit_exp = hsm::internal,                                          //
+            exp_sign_state(                                                                 //
+                minus / negate_exp                                        = exp_state,      //
+                plus                                                      = exp_state,      //
+                digit / add_digit_exp                                     = exp_state,      //
+                eoi / carry_number                                        = hsm::internal,  //
                 hsm::any / detail::error_action<invalid_number, self_t>() = error),
-            string_start_cont(                                       //
-                escape / mem_add_ch        = string_start_cont_esc,  //
-                quot / emit_str_first_last = array_object,           //
-                eoi / emit_str_first       = string_n,               //
-                hsm::any / mem_add_ch      = string_start_cont),          //
-            string_start_cont_esc(                                   //
-                hsm::any / mem_add_ch = string_start_cont,           //
-                eoi / emit_str_first  = string_n_esc),
-            string_n(quot / emit_str_n_last = array_object,          //
-                     escape / mem_n_str     = string_n_cont_esc,     //
-                     hsm::any / mem_n_str   = string_n_cont),          //
-            string_n_esc(hsm::any / mem_n_str = string_n_cont_esc),  //
-            string_n_cont(                                           //
-                hsm::any / mem_add_ch  = string_n_cont,              //
-                escape / mem_add_ch    = string_n_cont_esc,          //
-                quot / emit_str_n_last = array_object,               //
-                eoi / emit_str_n       = string_n),
-            string_n_cont_esc(                          //
-                hsm::any / mem_add_ch = string_n_cont,  //
-                eoi / emit_str_n      = string_n_esc),
-            member(                                                                         //
-                hsm::initial = expect_quot,                                                 //
-                expect_quot(                                                                //
-                    whitespace                                            = hsm::internal,  //
-                    eoi                                                   = hsm::internal,
-                    quot / mem_start_str                                  = name_start_cont,  //
-                    br_close[object_on_stack] / pop_object                = array_object,     //
-                    hsm::any / detail::error_action<member_exp, self_t>() = error),
-                name_start_cont(                                        //
-                    hsm::any / mem_add_ch       = name_start_cont,      //
-                    escape / mem_add_ch         = name_start_cont_esc,  //
-                    quot / emit_name_first_last = expect_colon,         //
-                    eoi / emit_name_first       = name_n),                    //
-                name_start_cont_esc(                                    //
-                    hsm::any / mem_add_ch = name_start_cont,            //
-                    eoi / emit_name_first = name_n_esc),
-                name_n(quot / emit_name_n_last = expect_colon,       //
-                       escape / mem_n_str      = name_n_cont_esc,    //
-                       hsm::any / mem_n_str    = name_n_cont),          //
-                name_n_esc(hsm::any / mem_n_str = name_n_cont_esc),  //
-                name_n_cont(                                         //
-                    hsm::any / mem_add_ch   = name_n_cont,           //
-                    escape / mem_add_ch     = name_n_cont_esc,       //
-                    quot / emit_name_n_last = expect_colon,          //
-                    eoi / emit_name_n       = name_n),
-                name_n_cont_esc(                          //
-                    hsm::any / mem_add_ch = name_n_cont,  //
-                    eoi / emit_name_n     = name_n_esc)),
-            expect_colon(                                                              //
-                whitespace                                           = expect_colon,   //
-                colon                                                = json_state,     //
-                eoi                                                  = hsm::internal,  //
-                hsm::any / detail::error_action<colon_exp, self_t>() = error),
-            keyword(                                                                                                //
-                eoi                                                                               = hsm::internal,  //
-                hsm::any[kw_consume] / kw_consume_char                                            = keyword,
-                hsm::any[kw_complete] / kw_complete_keyword                                       = array_object,  //
-                hsm::any[kw_wrong_char] / detail::error_action<wrong_keyword_character, self_t>() = error          //
+            comma / emit_float                                        = array_object_comma,      //
+            br_close / emit_float                                     = array_object_br_close,   //
+            idx_close / emit_float                                    = array_object_idx_close,  //
+            whitespace / emit_float                                   = array_object,            //
+            eoi / carry_number                                        = hsm::internal,           //
+            hsm::any / detail::error_action<invalid_number, self_t>() = error),
+        string_start_cont(                                       //
+            escape / mem_add_esc       = string_start_cont_esc,  //
+            quot / emit_str_first_last = array_object,           //
+            eoi / emit_str_first       = string_n,               //
+            hsm::any / mem_add_ch      = string_start_cont),          //
+        string_start_cont_esc(                                   //
+            hsm::any / mem_add_ch = string_start_cont,           //
+            eoi / emit_str_first  = string_n_esc),
+        string_n(quot / emit_str_n_last = array_object,          //
+                 escape / mem_n_esc     = string_n_cont_esc,     //
+                 hsm::any / mem_n_str   = string_n_cont),          //
+        string_n_esc(hsm::any / mem_n_str = string_n_cont),      //
+        string_n_cont(                                           //
+            hsm::any / mem_add_ch  = string_n_cont,              //
+            escape / mem_add_esc   = string_n_cont_esc,          //
+            quot / emit_str_n_last = array_object,               //
+            eoi / emit_str_n       = string_n),
+        string_n_cont_esc(                          //
+            hsm::any / mem_add_ch = string_n_cont,  //
+            eoi / emit_str_n      = string_n_esc),
+        member(                                                                         //
+            hsm::initial = expect_quot,                                                 //
+            expect_quot(                                                                //
+                whitespace                                            = hsm::internal,  //
+                eoi                                                   = hsm::internal,
+                quot / mem_start_str                                  = name_start_cont,  //
+                br_close[object_on_stack] / pop_object                = array_object,     //
+                hsm::any / detail::error_action<member_exp, self_t>() = error),
+            name_start_cont(                                        //
+                hsm::any / mem_add_ch       = name_start_cont,      //
+                escape / mem_add_esc        = name_start_cont_esc,  //
+                quot / emit_name_first_last = expect_colon,         //
+                eoi / emit_name_first       = name_n),                    //
+            name_start_cont_esc(                                    //
+                hsm::any / mem_add_ch = name_start_cont,            //
+                eoi / emit_name_first = name_n_esc),
+            name_n(quot / emit_name_n_last = expect_colon,       //
+                   escape / mem_n_esc      = name_n_cont_esc,    //
+                   hsm::any / mem_n_str    = name_n_cont),          //
+            name_n_esc(hsm::any / mem_n_str = name_n_cont),      //
+            name_n_cont(                                         //
+                hsm::any / mem_add_ch   = name_n_cont,           //
+                escape / mem_add_esc    = name_n_cont_esc,       //
+                quot / emit_name_n_last = expect_colon,          //
+                eoi / emit_name_n       = name_n),
+            name_n_cont_esc(                          //
+                hsm::any / mem_add_ch = name_n_cont,  //
+                eoi / emit_name_n     = name_n_esc)),
+        expect_colon(                                                              //
+            whitespace                                           = expect_colon,   //
+            colon                                                = json_state,     //
+            eoi                                                  = hsm::internal,  //
+            hsm::any / detail::error_action<colon_exp, self_t>() = error),
+        keyword(                                                                                                //
+            eoi                                                                               = hsm::internal,  //
+            hsm::any[kw_consume] / kw_consume_char                                            = keyword,
+            hsm::any[kw_complete] / kw_complete_keyword                                       = array_object,  //
+            hsm::any[kw_wrong_char] / detail::error_action<wrong_keyword_character, self_t>() = error          //
+            ),
+        array_object(                                   //
+            hsm::initial[stack_empty] = done,           //
+            whitespace                = hsm::internal,  //
+            eoi                       = hsm::internal,  //
+            comma                     = array_object_comma,
+            array_object_comma(                             //
+                hsm::initial[object_on_stack] = member,     //
+                hsm::initial[array_on_stack]  = json_state  //
                 ),
-            array_object(                                   //
-                hsm::initial[stack_empty] = done,           //
-                whitespace                = hsm::internal,  //
-                eoi                       = hsm::internal,  //
-                comma                     = array_object_comma,
-                array_object_comma(                             //
-                    hsm::initial[object_on_stack] = member,     //
-                    hsm::initial[array_on_stack]  = json_state  //
-                    ),
-                br_close = array_object_br_close,
-                array_object_br_close(                                                                            //
-                    hsm::initial[no_object_on_stack] / detail::error_action<mismatched_brace, self_t>() = error,  //
-                    hsm::initial[object_on_stack] / pop_object                                          = array_object),
-                idx_close = array_object_idx_close,
-                array_object_idx_close(                                                                          //
-                    hsm::initial[no_array_on_stack] / detail::error_action<mismatched_array, self_t>() = error,  //
-                    hsm::initial[array_on_stack] / pop_array                                           = array_object),
-                hsm::any / detail::error_action<comma_expected, self_t>() = error  //
-                ));
-        sm.start(*this);
-        process_events = [sm = std::move(sm)](sv_t const& bytes, int ctrl, self_t& self) mutable {
-            if (ctrl < 0) sm.start(self);
-            self.current_input_buffer = bytes;
+            br_close = array_object_br_close,
+            array_object_br_close(                                                                            //
+                hsm::initial[no_object_on_stack] / detail::error_action<mismatched_brace, self_t>() = error,  //
+                hsm::initial[object_on_stack] / pop_object                                          = array_object),
+            idx_close = array_object_idx_close,
+            array_object_idx_close(                                                                          //
+                hsm::initial[no_array_on_stack] / detail::error_action<mismatched_array, self_t>() = error,  //
+                hsm::initial[array_on_stack] / pop_array                                           = array_object),
+            hsm::any / detail::error_action<comma_expected, self_t>() = error  //
+            ));
+}
+}  // namespace detail
+
+template <typename Handler = default_handler<default_traits>, typename Traits = default_traits>
+struct basic_json_parser
+{
+    using float_t   = typename Traits::float_t;
+    using integer_t = typename Traits::integer_t;
+    using sv_t      = typename Traits::sv_t;
+
+   private:
+    using state_t = detail::parser_state<Handler, Traits>;
+    using sm_t    = decltype(detail::create_parser_sm<state_t>());
+    state_t state;
+    sm_t    sm{detail::create_parser_sm<state_t>()};
+
+    template <typename... States>
+    uint64_t state_mask(States... states)
+    {
+        return ((uint64_t{1} << static_cast<unsigned>(sm.get_state_id(states))) | ...);
+    }
+    bool in_state(uint64_t mask) const { return mask & (uint64_t{1} << static_cast<unsigned>(sm.current_state_id())); }
+
 #ifdef ASYNC_JSON_PARSER_DEBUG
-            auto to_state_name = [](int d) -> char const* {
-                char const* fpp[] = {"root",
-                                     "done",
-                                     "error",
-                                     "json_state",
-                                     "json_state_in_array",
-                                     "int_number_state",
-                                     "int_number_ws",
-                                     "fraction_number",
-                                     "esp_state",
-                                     "exp_sign_state",
-                                     "string_start_cont",
-                                     "string_start_cont_esc",
-                                     "string_n",
-                                     "string_n_esc",
-                                     "string_n_cont",
-                                     "string_n_cont_esc",
-                                     "member",
-                                     "expect_quot",
-                                     "name_star_cont",
-                                     "name_start_cont_esc",
-                                     "name_n",
-                                     "name_n_esc",
-                                     "name_n_cont",
-                                     "name_n_cont_esc",
-                                     "expect_colon",
-                                     "keyword",
-                                     "array_object",
-                                     "array_object_comma",
-                                     "array_object_br_close",
-                                     "array_object_idx_close"};
-                return fpp[d];
-            };
+    /// name of the current state, looked up through the state ids of the state machine
+    char const* state_name() const
+    {
+        using namespace async_json::detail;
+        auto const  id   = sm.current_state_id();
+        char const* name = "root";
+        auto        is   = [this, id, &name](auto const& s, char const* n) {
+            if (sm.get_state_id(s) == id) name = n;
+        };
+        is(done, "done"), is(error, "error"), is(json_state, "json_state"), is(json_state_in_array, "json_state_in_array");
+        is(keyword, "keyword"), is(member, "member"), is(expect_quot, "expect_quot"), is(expect_colon, "expect_colon");
+        is(int_number_state, "int_number_state"), is(int_number_minus, "int_number_minus");
+        is(fraction_number, "fraction_number"), is(exp_sign_state, "exp_sign_state"), is(exp_state, "exp_state");
+        is(string_start_cont, "string_start_cont"), is(string_start_cont_esc, "string_start_cont_esc");
+        is(string_n, "string_n"), is(string_n_esc, "string_n_esc");
+        is(string_n_cont, "string_n_cont"), is(string_n_cont_esc, "string_n_cont_esc");
+        is(name_start_cont, "name_start_cont"), is(name_start_cont_esc, "name_start_cont_esc");
+        is(name_n, "name_n"), is(name_n_esc, "name_n_esc"), is(name_n_cont, "name_n_cont"), is(name_n_cont_esc, "name_n_cont_esc");
+        is(array_object, "array_object"), is(array_object_comma, "array_object_comma");
+        is(array_object_br_close, "array_object_br_close"), is(array_object_idx_close, "array_object_idx_close");
+        return name;
+    }
 #endif
-            auto switch_char = [&sm](char c, self_t& s) mutable {
-                switch (c)
+
+    void extend_parsed_view(size_t count) { state.parsed_view = sv_t(state.parsed_view.data(), state.parsed_view.size() + count); }
+
+    /// fast forwards over input a handler asked to skip, returns the position of the next byte the state machine has to see
+    size_t skip(char const* data, size_t pos, size_t size)
+    {
+        using namespace async_json::detail;
+        using skip_mode = typename state_t::skip_mode;
+        switch (state.skipping)
+        {
+            case skip_mode::none: return pos;
+            case skip_mode::pending_value:
+            {
+                if (sm.current_state_id() != sm.get_state_id(json_state)) return pos;  // colon not seen yet
+                pos = static_cast<size_t>(skip_whitespace(data + pos, data + size) - data);
+                if (pos == size) return size;
+                char const c   = data[pos];
+                bool const str = c == '"';
+                state.skipping       = str || c == '{' || c == '[' ? skip_mode::value : skip_mode::scalar;
+                state.skipper        = skip_scanner{str ? 0u : 1u, str, false};
+                state.scalar_skipper = scalar_scanner{};
+                return skip(data, state.skipping == skip_mode::value ? pos + 1 : pos, size);
+            }
+            case skip_mode::scalar:
+            {
+                // numbers and keywords end at a delimiter, which the state machine still has to see
+                auto& scalar = state.scalar_skipper;
+                pos          = static_cast<size_t>(scalar.find_end(data + pos, data + size) - data);
+                if (pos == size) return size;
+                state.skipping = skip_mode::none;
+                if (scalar.invalid)
                 {
-                    case 'n': return sm.process_event(n, s);
-                    case 't': return sm.process_event(t, s);
-                    case 'f': return sm.process_event(f, s);
-                    case '{': return sm.process_event(br_open, s);
-                    case '}': return sm.process_event(br_close, s);
-                    case '[': return sm.process_event(idx_open, s);
-                    case ']': return sm.process_event(idx_close, s);
-                    case '"': return sm.process_event(quot, s);
-                    case ':': return sm.process_event(colon, s);
-                    case ',': return sm.process_event(comma, s);
-                    case '+': return sm.process_event(plus, s);
-                    case '-': return sm.process_event(minus, s);
-                    case '0': /* fall-through */
-                    case '1':
-                    case '2':
-                    case '3':
-                    case '4':
-                    case '5':
-                    case '6':
-                    case '7':
-                    case '8':
-                    case '9': return sm.process_event(digit, s);
-                    case '\\': return sm.process_event(escape, s);
-                    case 'E':
-                    case 'e': return sm.process_event(exponent, s);
-                    case '.': return sm.process_event(dot, s);
-                    case ' ':
-                    case '\b':
-                    case '\t':
-                    case '\r':
-                    case '\n': return sm.process_event(whitespace, s);
-                    default: return sm.process_event(ch, s);
+                    using stage = scalar_scanner::stage;
+                    state.callback_handler()->error(scalar.at == stage::start     ? unexpected_character
+                                                    : scalar.at == stage::keyword ? wrong_keyword_character
+                                                                                  : invalid_number);
+                    sm.process_event(skipped_invalid, state);
+                    return pos;
                 }
-            };
-            for (auto elem : bytes)
+                sm.process_event(skipped, state);
+                return pos;
+            }
+            case skip_mode::value:
+            case skip_mode::container:
             {
-                self.cur = elem;
+                auto const end = static_cast<size_t>(state.skipper.find_end(data + pos, data + size) - data);
+                if (end == size) return size;
+                // the state machine closes a skipped container itself, so the handler sees the matching end
+                if (state.skipping == skip_mode::container)
+                {
+                    state.skipping = skip_mode::none;
+                    return end;
+                }
+                state.skipping = skip_mode::none;
+                sm.process_event(skipped, state);
+                return end + 1;
+            }
+        }
+        return pos;
+    }
+
+    bool process_events(sv_t const& bytes)
+    {
+        using namespace async_json::detail;
+        state.current_input_buffer = bytes;
+        using event_id = typename std::decay_t<decltype(sm)>::event_id;
+        // states that only append plain characters to parsed_view until the next '"' or '\\'
+        auto const string_body = state_mask(string_start_cont, string_n_cont, name_start_cont, name_n_cont);
+        // states in which whitespace is consumed without any action
+        auto const whitespace_skip =
+            state_mask(json_state, json_state_in_array, array_object, expect_colon, expect_quot);
+        auto const error_id = sm.get_state_id(error);
+        auto const size     = bytes.size();
+        auto const data     = bytes.data();
+        for (size_t i = skip(data, 0, size); i < size; ++i)
+        {
+            state.cur       = data[i];
+            state.input_pos = i;
 #ifdef ASYNC_JSON_PARSER_DEBUG
-                std::cout << "Parse: '" << self.cur << "' " << to_state_name(static_cast<int>(sm.current_state_id())) << std::endl;
+            std::cout << "Parse: '" << state.cur << "' " << state_name() << std::endl;
 #endif
-                switch_char(self.cur, self);
-                if (sm.current_state_id() == sm.get_state_id(error)) return false;
-                ++self.byte_count;
-                self.current_input_buffer = sv_t(self.current_input_buffer.begin() + 1, self.current_input_buffer.size() - 1);
+            sm.process_event(static_cast<event_id>(char_classes[state.cur]), state);
+            if (sm.current_state_id() == error_id)
+            {
+                state.byte_count += i;
+                return false;
             }
-            sm.process_event(eoi, self);
-            return sm.current_state_id() != sm.get_state_id(error);
-        };
+            if (state.skipping != state_t::skip_mode::none)
+            {
+                auto const resume = skip(data, i + 1, size);
+                if (resume != i + 1)
+                {
+                    i = resume - 1;
+                    continue;
+                }
+            }
+            if (in_state(string_body))
+            {
+                auto const run = static_cast<size_t>(find_quote_or_escape(data + i + 1, data + size) - (data + i + 1));
+                extend_parsed_view(run);
+                i += run;
+            }
+            else if (in_state(whitespace_skip))
+            {
+                i = static_cast<size_t>(skip_whitespace(data + i + 1, data + size) - data) - 1;
+            }
+        }
+        state.byte_count += size;
+        state.input_pos  = size;
+        sm.process_event(eoi, state);
+        return sm.current_state_id() != sm.get_state_id(error);
+    }
+
+    /// same as process_events, but the state machine only sees the bytes selected by the structural_scanner, and numbers and
+    /// keywords as one event each
+    bool process_indexed(sv_t const& bytes)
+    {
+        using namespace async_json::detail;
+        using event_id             = typename std::decay_t<decltype(sm)>::event_id;
+        state.current_input_buffer = bytes;
+        auto const string_body     = state_mask(string_start_cont, string_n_cont, name_start_cont, name_n_cont);
+        auto const escaped =
+            state_mask(string_start_cont_esc, string_n_esc, string_n_cont_esc, name_start_cont_esc, name_n_esc, name_n_cont_esc);
+        auto const in_string   = string_body | escaped | state_mask(string_n, name_n);
+        auto const value_start = state_mask(json_state, json_state_in_array);
+        auto const error_id    = sm.get_state_id(error);
+        auto const size      = bytes.size();
+        auto const data      = bytes.data();
+
+        // the scanner state at the start of the input buffer follows from where the state machine stopped
+        structural_scanner scanner{in_state(in_string), in_state(escaped), false};
+        size_t             block = skip(data, 0, size);
+        size_t             next  = block;  // first byte the state machine has not seen or skipped yet
+        // the first byte is always needed to continue a string that was cut by the previous input buffer
+        bool restart = true;
+        while (block < size)
+        {
+            char        padded[64];
+            char const* ptr       = data + block;
+            auto const  remaining = size - block;
+            if (remaining < 64)
+            {
+                std::memset(padded, ' ', sizeof padded);
+                std::memcpy(padded, ptr, remaining);
+                ptr = padded;
+            }
+            uint64_t selected = scanner.next(ptr) | (restart ? 1 : 0);
+            if (remaining < 64) selected &= (uint64_t{1} << remaining) - 1;
+            restart = false;
+            for (; selected; selected &= selected - 1)
+            {
+                auto const i = block + count_trailing_zeros(selected);
+                if (i != next && in_state(string_body)) extend_parsed_view(i - next);
+                state.cur       = data[i];
+                state.input_pos = i;
+                if (in_state(value_start) && starts_scalar(state.cur))
+                {
+                    // a valid number or keyword that ends in this input buffer reaches the state machine as one event, the
+                    // others still go byte by byte so that the state machine reports the error or carries the number over
+                    state.run       = scalar_scanner{};
+                    auto const end  = static_cast<size_t>(state.run.find_end(data + i, data + size) - data);
+                    if (end != size && !state.run.invalid)
+                    {
+                        state.run_end = end;
+                        if (state.run.at == scalar_scanner::stage::keyword)
+                            sm.process_event(keyword_run, state);
+                        else
+                            sm.process_event(number_run, state);
+                        next = end;
+                        if (end - block < 64)
+                        {
+                            // drop the selected bytes of the run, the loop increment drops i itself
+                            selected = (selected & (~uint64_t{0} << (end - block))) | (uint64_t{1} << (i - block));
+                            continue;
+                        }
+                        // the run ends outside of a string in a later block, scanning restarts behind it
+                        scanner = structural_scanner{};
+                        restart = true;
+                        break;
+                    }
+                }
+                sm.process_event(static_cast<event_id>(char_classes[state.cur]), state);
+                if (sm.current_state_id() == error_id)
+                {
+                    state.byte_count += i;
+                    return false;
+                }
+                next = i + 1;
+                if (state.skipping != state_t::skip_mode::none)
+                {
+                    auto const resume = skip(data, next, size);
+                    if (resume != next)
+                    {
+                        // skipped values end outside of strings, so scanning restarts from a clean state behind them
+                        next    = resume;
+                        scanner = structural_scanner{};
+                        restart = true;
+                        break;
+                    }
+                }
+            }
+            block = restart ? next : block + 64;
+        }
+        if (next != size && in_state(string_body)) extend_parsed_view(size - next);
+        state.byte_count += size;
+        state.input_pos  = size;
+        sm.process_event(eoi, state);
+        return sm.current_state_id() != error_id;
+    }
+
+    static bool starts_scalar(char c) noexcept { return (c >= '0' && c <= '9') || c == '-' || c == 't' || c == 'f' || c == 'n'; }
+
+    /// true when every char_class is the hsm event id of its character event
+    bool char_classes_match_events() const
+    {
+        using namespace async_json::detail;
+        auto is = [this](auto const& ev, char_class cc) { return static_cast<unsigned>(sm.get_event_id(ev)) == static_cast<unsigned>(cc); };
+        return is(ch, char_class::other) && is(digit, char_class::digit) && is(quot, char_class::quot) &&
+               is(colon, char_class::colon) && is(comma, char_class::comma) && is(dot, char_class::dot) &&
+               is(exponent, char_class::exponent) && is(plus, char_class::plus) && is(minus, char_class::minus) &&
+               is(br_open, char_class::br_open) && is(br_close, char_class::br_close) && is(idx_open, char_class::idx_open) &&
+               is(idx_close, char_class::idx_close) && is(whitespace, char_class::whitespace) && is(t, char_class::t) &&
+               is(f, char_class::f) && is(n, char_class::n) && is(escape, char_class::escape) && is(eoi, char_class::eoi);
     }
 
    public:
-    explicit basic_json_parser(Handler&& handler) : cbs(std::move(handler)) { setup_sm(); }
-    basic_json_parser() { setup_sm(); }
+    explicit basic_json_parser(Handler&& handler) : state(std::move(handler))
+    {
+        assert(char_classes_match_events() && "char_class does not follow the event order of create_parser_sm");
+        sm.start(state);
+    }
+    basic_json_parser()
+    {
+        assert(char_classes_match_events() && "char_class does not follow the event order of create_parser_sm");
+        sm.start(state);
+    }
 
-    Handler* callback_handler() { return &cbs; }
-    bool     parse_bytes(sv_t const& input) { return process_events(input, 0, *this); }
-    void     reset()
+    Handler* callback_handler() { return state.callback_handler(); }
+    /// handlers with a chunk_end() method are notified after each input buffer, while views into it are still valid
+    bool parse_bytes(sv_t const& input)
     {
-        state_stack.clear();
-        num_sign    = 1;
-        exp_sign    = 1;
-        frac_digits = 0;
-        exp_number  = 0;
-        int_number  = 0;
-        fraction    = 0;
-        byte_count  = 0;
-        process_events(sv_t{}, -1, *this);
+        bool ret;
+        if constexpr (state_t::structural_index)
+            ret = process_indexed(input);
+        else
+            ret = process_events(input);
+        if constexpr (detail::has_chunk_end<Handler>::value) state.cbs.chunk_end();
+        return ret;
+    }
+    /// prepares for the next document, handlers with a reset() method are reset as well
+    void reset()
+    {
+        state.reset();
+        if constexpr (detail::has_reset<Handler>::value) state.cbs.reset();
+        sm.start(state);
     }
 };
 }  // namespace async_json
@@ -31,7 +31,27 @@ enum error_cause
     colon_exp,
     unexpected_character,
     invalid_number,
-    comma_expected
+    comma_expected,
+    integer_overflow
+};
+
+/// how the parser reports integer literals that do not fit into Traits::integer_t
+enum class overflow_policy
+{
+    promote_to_float,  ///< convert to Traits::float_t and report it through value(float_t)
+    raw_text,          ///< report the decimal digits through number_value(sv_t const&)
+    error              ///< stop parsing with integer_overflow
+};
+
+/// Handlers may return this from named_object, named_object_start, named_object_cont, named_object_end, object_start and
+/// array_start. On skip the parser fast forwards over the member value or the rest of the container without further events,
+/// only the object_end or array_end of a skipped container is still reported. Skipped numbers and keywords are still checked
+/// against the grammar, a skipped string, object or array is only scanned for its end: its content is not validated beyond
+/// matching quotes and brackets.
+enum class parse_verdict
+{
+    proceed,
+    skip
 };
 
 struct default_traits
@@ -39,6 +59,20 @@ struct default_traits
     using float_t   = double;
     using integer_t = long;
     using sv_t      = std::string_view;
+
+    static constexpr overflow_policy integer_overflow_policy = overflow_policy::promote_to_float;
+    /// report numbers unconverted through number_value(sv_t const&) instead of value(integer_t) and value(float_t)
+    static constexpr bool raw_numbers = false;
+    /// run the parser state machine only on the bytes selected by a 64 byte block wise structural index, numbers and keywords
+    /// that end in the input buffer are checked in one pass and reach it as one event
+    static constexpr bool structural_index = false;
+    /// copy strings and member names that span input buffers into a buffer of the parser and report them complete through
+    /// value(sv_t const&) and named_object(sv_t const&), instead of the string_value_* and named_object_* fragments; the
+    /// reported view is only valid until the next string or member name event, copy it to keep it
+    static constexpr bool contiguous_strings = false;
+    /// report strings and member names with escape sequences decoded to UTF-8, strings without escapes are not copied; the
+    /// decoded text lives in a buffer of the parser and is only valid until the next string or member name fragment
+    static constexpr bool decode_escapes = false;
 };
 
 }  // namespace async_json
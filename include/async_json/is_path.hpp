@@ -8,7 +8,9 @@
 #define ASYNC_JSON_IS_PATH_HPP_INCLUDED
 
 #include <async_json/saj_event_mapper.hpp>
+#include <async_json/simd_scan.hpp>
 #include <hsm/hsm.hpp>
+#include <array>
 
 namespace async_json
 {
@@ -16,13 +18,7 @@ namespace detail
 {
 inline bool begins_with(std::string_view const& str, std::string_view const& b)
 {
-    auto i1 = str.begin();
-    auto e1 = str.end();
-    auto i2 = b.begin();
-    auto e2 = b.end();
-    for (; i1 != e1 && i2 != e2; ++i1, ++i2)
-        if (*i1 != *i2) return false;
-    return i2 == e2;
+    return b.size() <= str.size() && equal_bytes(str.data(), b.data(), b.size());
 }
 
 constexpr hsm::state_ref<struct expect_object_s>         expect_object;
@@ -41,7 +37,9 @@ constexpr hsm::state_ref<struct ds_s>                    ds;
 enum class path_type : uint8_t
 {
     string,
-    arbitrary
+    arbitrary,
+    elements,    // array elements with an index in [first, last), only understood by path()
+    descendants  // the value and all values nested in it at any depth, only understood by path()
 };
 
 struct path_element
@@ -49,19 +47,23 @@ struct path_element
     std::string_view str;
     path_type        type;
     bool             in_array{false};
+    size_t           first{0};
+    size_t           last{0};
     constexpr path_element(std::string_view const& s) : str{s}, type{path_type::string} {}
     constexpr path_element(char const* s) : str{s}, type{path_type::string} {}
     constexpr path_element(path_type pt) : str{}, type{pt} {}
+    constexpr path_element(size_t f, size_t l) : str{}, type{path_type::elements}, first{f}, last{l} {}
 };
 
+template <size_t N>
 struct is_path
 {
-    std::vector<path_element> path_elements;
+    std::array<path_element, N> path_elements;
     template <typename... Ts>
-    is_path(Ts&&... ts) : path_elements{ts...}
+    constexpr is_path(Ts&&... ts) : path_elements{{path_element(std::forward<Ts>(ts))...}}
     {
     }
-    inline bool at_end() const { return element == path_elements.size(); }
+    constexpr bool at_end() const { return element == N; }
     inline int  depth() const { return dislocation; }
     inline bool matches_element_begin(std::string_view const& sv)
     {
@@ -110,8 +112,10 @@ struct is_path
     std::string_view str_val{};
 };
 
-inline auto create_path_sm(is_path&& obj)
+template <size_t N>
+inline auto create_path_sm(is_path<N>&& obj)
 {
+    using is_path = detail::is_path<N>;
     auto match_begin               = [](is_path& self) { return self.matches_element_begin(self.str_val); };
     auto match_part                = [](is_path& self) { return self.matches_element_part(self.str_val); };
     auto match_end                 = [](is_path& self) { return self.element_complete(); };
@@ -207,7 +211,7 @@ inline auto create_path_sm(is_path&& obj)
 template <typename... Ts>
 inline auto is_path(Ts&&... ts) noexcept
 {
-    return [path_sm = detail::create_path_sm(detail::is_path(std::forward<Ts>(ts)...))](auto const& ev) mutable {
+    return [path_sm = detail::create_path_sm(detail::is_path<sizeof...(Ts)>(std::forward<Ts>(ts)...))](auto const& ev) mutable {
         auto& path_state     = tiny_tuple::get<0>(path_sm);
         auto& sm             = tiny_tuple::get<1>(path_sm);
         path_state.has_value = ev.has_value();
@@ -222,6 +226,14 @@ inline auto is_path(Ts&&... ts) noexcept
     };
 };
 constexpr detail::path_element arbitrary{detail::path_type::arbitrary};
+/// every element of an array
+constexpr detail::path_element each{0, ~size_t{0}};
+/// the element at position n of an array
+constexpr detail::path_element index(size_t n) noexcept { return detail::path_element{n, n + 1}; }
+/// the elements of an array with a position in [first, last)
+constexpr detail::path_element slice(size_t first, size_t last) noexcept { return detail::path_element{first, last}; }
+/// the current value and every value nested in it, like JSONPath "..": path(f, descendants, "id") selects all members "id"
+constexpr detail::path_element descendants{detail::path_type::descendants};
 
 }  // namespace async_json
 
@@ -9,137 +9,188 @@
 
 #include <async_json/basic_json_parser.hpp>
 #include <async_json/is_path.hpp>
+#include <async_json/path_compiler.hpp>
+#include <async_json/path_trie.hpp>
+#include <async_json/string_arena.hpp>
+#include <async_json/value_handler.hpp>
+#include <array>
 #include <memory>
 #include <type_traits>
+#include <utility>
 
 namespace async_json
 {
 namespace detail
 {
-template <typename Traits, typename T, typename EH>
-struct value_handler;
+/// created by path(): an action and the path elements that select the values passed to it
+template <typename A, size_t N>
+struct path_descriptor
+{
+    A                           action;
+    std::array<path_element, N> elements;
+};
 
-template <typename Traits, typename T, typename EH>
-struct value_handler : default_handler<Traits>
+/// created by path() from a compiled_path
+template <typename A>
+struct compiled_path_descriptor
 {
-    using integer_t = typename Traits::integer_t;
-    using sv_t      = typename Traits::sv_t;
-    using float_t   = typename Traits::float_t;
-    T&   destination;
-    EH&  error_handler;
-    bool astart{false};
-    value_handler(T& dest, EH&& eh) : destination{dest}, error_handler{eh} {}
-    template <typename VT>
-    void value(VT const& vt, typename std::enable_if<std::is_convertible<VT, T>::value>::type* /*ptr*/ = nullptr)
-    {
-        destination = vt;
-    }
-    template <typename VT>
-    void value(VT const&, typename std::enable_if<!std::is_convertible<VT, T>::value>::type* /*ptr*/ = nullptr)
-    {
-        error_handler();
-    }
-    void string_value_start(sv_t const&) { error_handler(); }
-    void string_value_cont(sv_t const&) { error_handler(); }
-    void string_value_end() { error_handler(); }
-    void array_start() { error_handler(); }
-    void array_end() { error_handler(); }
+    A             action;
+    compiled_path elements;
 };
 
-template <typename Traits, typename T, typename A, typename EH>
-struct value_handler<Traits, std::vector<T, A>, EH> : default_handler<Traits>
+template <typename T>
+struct is_path_descriptor : std::false_type
 {
-    using integer_t = typename Traits::integer_t;
-    using sv_t      = typename Traits::sv_t;
-    using float_t   = typename Traits::float_t;
-    T&   destination;
-    EH&  error_handler;
-    bool astart{false};
-    value_handler(std::vector<T, A>& dest, EH&& eh) : destination{dest}, error_handler{eh} {}
-    template <typename VT>
-    void value(VT const& vt, typename std::enable_if<std::is_convertible<VT, T>::value>::type* /*ptr*/ = nullptr)
-    {
-        destination.push_back(vt);
-    }
-    template <typename VT>
-    void value(VT const&, typename std::enable_if<!std::is_convertible<VT, T>::value>::type* /*ptr*/ = nullptr)
-    {
-        error_handler();
-    }
-    void string_value_start(sv_t const&) { error_handler(); }
-    void string_value_cont(sv_t const&) { error_handler(); }
-    void string_value_end() { error_handler(); }
-    void array_start() { astart = true; }
-    void array_end() { astart = false; }
 };
 
-template <typename Traits, typename A, typename EH>
-struct value_handler<Traits, std::vector<std::string, A>, EH> : default_handler<Traits>
+template <typename A>
+struct is_path_descriptor<compiled_path_descriptor<A>> : std::true_type
 {
-    using integer_t = typename Traits::integer_t;
-    using sv_t      = typename Traits::sv_t;
-    using float_t   = typename Traits::float_t;
-    std::vector<std::string, A>& destination;
-    EH                           error_handler;
-    bool                         astart{false};
-    value_handler(std::vector<std::string, A>& dest, EH&& eh) : destination{dest}, error_handler{eh} {}
-    template <typename VT>
-    void value(VT const&)
-    {
-        error_handler();
-    }
-    void value(sv_t const& str)
-    {
-        if (astart) destination.emplace_back(str.begin(), str.end());
-    }
-    void string_value_start(sv_t const& s)
-    {
-        if (astart) destination.emplace_back(s.begin(), s.end());
-    }
-    void string_value_cont(sv_t const& s)
-    {
-        if (astart) destination.back().append(s.begin(), s.end());
-    }
-    void string_value_end() {}
-    void array_start() { astart = true; }
-    void array_end() { astart = false; }
 };
 
-template <typename Traits, typename EH>
-struct value_handler<Traits, std::string, EH> : default_handler<Traits>
+template <typename A, size_t N>
+struct is_path_descriptor<path_descriptor<A, N>> : std::true_type
+{
+};
+
+template <typename T>
+struct path_size : std::integral_constant<size_t, 0>
+{
+};
+
+template <typename A, size_t N>
+struct path_size<path_descriptor<A, N>> : std::integral_constant<size_t, N>
+{
+};
+
+template <typename A>
+struct path_size<compiled_path_descriptor<A>> : std::integral_constant<size_t, dynamic_size>
+{
+};
+
+template <typename T>
+struct action_of
+{
+    using type = T;
+};
+
+template <typename A, size_t N>
+struct action_of<path_descriptor<A, N>>
+{
+    using type = A;
+};
+
+template <typename A>
+struct action_of<compiled_path_descriptor<A>>
+{
+    using type = A;
+};
+
+/// actions that are invocable with the event and the string_arena of the extractor get both
+template <typename T, typename Traits>
+struct takes_arena : std::is_invocable<typename action_of<T>::type&, saj_event_value<Traits> const&, string_arena&>
 {
-    using integer_t = typename Traits::integer_t;
-    using sv_t      = typename Traits::sv_t;
-    using float_t   = typename Traits::float_t;
-    std::string& destination;
-    EH           error_handler;
-    value_handler(std::string& dest, EH&& eh) : destination{dest}, error_handler{eh} {}
-    using default_handler<Traits>::value;
-    void value(sv_t const& str) { destination.assign(str.begin(), str.end()); }
-    void string_value_start(sv_t const& s) { destination.assign(s.begin(), s.end()); }
-    void string_value_cont(sv_t const& s) { destination.append(s.begin(), s.end()); }
-    void string_value_end() {}
-    void array_start() {}
-    void array_end() {}
 };
 
+/// path descriptors are compiled into one path_matcher, other callables still see every event
 template <typename Traits, typename EH, typename... Ts>
 struct extractor : saj_event_mapper<extractor<Traits, EH, Ts...>, Traits>
 {
-    tiny_tuple::tuple<Ts...> data;
-    EH                       error_handler;
-    constexpr extractor(EH&& eh, Ts&&... ts) noexcept : data{ts...}, error_handler{eh} {}
+    static constexpr size_t path_elements = sum_capacity({size_t{0}, path_size<std::decay_t<Ts>>::value...});
+    static constexpr size_t path_count    = (size_t{is_path_descriptor<std::decay_t<Ts>>::value} + ... + 0);
+    static constexpr bool   uses_arena    = (takes_arena<std::decay_t<Ts>, Traits>::value || ...);
+    using trie_t                          = path_trie<path_elements, path_count>;
+
+    tiny_tuple::tuple<Ts...>     data;
+    EH                           error_handler;
+    path_matcher<Traits, trie_t> matcher;
+    /// holds the selected strings for actions that take a string_arena&, from the first event of a string until reset()
+    string_arena arena;
+    extractor(EH&& eh, Ts&&... ts) : data{ts...}, error_handler{eh} { add_paths(std::index_sequence_for<Ts...>{}); }
     using sv_t      = typename Traits::sv_t;
     using integer_t = typename Traits::integer_t;
     using float_t   = typename Traits::float_t;
     using ev_t      = saj_event_value<Traits>;
-    void process_event(ev_t const& ev)
+    /// values that no path selects are skipped, unless there are other callables that want to see every event
+    parse_verdict process_event(ev_t const& ev)
     {
-        if (ev.event != saj_event::parse_error)
-            tiny_tuple::foreach (data, [&ev](auto& i) { i(ev); });
-        else
+        if (ev.event == saj_event::parse_error)
+        {
             error_handler(ev.as_error_cause());
+            return parse_verdict::proceed;
+        }
+        // only strings that reach an action taking the arena are copied into it
+        bool       collected = false;
+        auto const verdict   = matcher.process_event(ev, [this, &collected](uint32_t action, ev_t const& e) {
+            if constexpr (uses_arena)
+                if (arena_actions[action] && !collected) collected = collect_string(e);
+            actions[action](*this, e);
+        });
+        if constexpr (path_count == sizeof...(Ts))
+            return verdict;
+        else
+        {
+            tiny_tuple::foreach (data, [this, &ev, &collected](auto& i) {
+                using type = std::decay_t<decltype(i)>;
+                if constexpr (is_path_descriptor<type>::value)
+                    return;
+                else if constexpr (takes_arena<type, Traits>::value)
+                {
+                    if (!collected) collected = collect_string(ev);
+                    i(ev, arena);
+                }
+                else
+                    i(ev);
+            });
+            return parse_verdict::proceed;
+        }
     }
+
+    void chunk_end() { matcher.chunk_end(); }
+
+    /// prepares for the next document, views into the arena become invalid
+    void reset()
+    {
+        matcher.reset();
+        arena.reset();
+    }
+
+   private:
+    bool collect_string(ev_t const& ev)
+    {
+        if (ev.event == saj_event::string_value_start) arena.begin();
+        if (ev.event == saj_event::string_value_start || ev.event == saj_event::string_value_cont)
+            arena.append(std::string_view(ev.as_string_view().data(), ev.as_string_view().size()));
+        return true;
+    }
+
+    template <size_t I>
+    static void call_action(extractor& self, ev_t const& ev)
+    {
+        auto& p = tiny_tuple::get<I>(self.data);
+        if constexpr (!is_path_descriptor<std::decay_t<decltype(p)>>::value)
+            return;
+        else if constexpr (takes_arena<std::decay_t<decltype(p)>, Traits>::value)
+            p.action(ev, self.arena);
+        else
+            p.action(ev);
+    }
+    template <size_t... Is>
+    void add_paths(std::index_sequence<Is...>)
+    {
+        auto add = [this](auto& p, uint32_t id) {
+            if constexpr (is_path_descriptor<std::decay_t<decltype(p)>>::value) matcher.add_path(p.elements.begin(), p.elements.end(), id);
+        };
+        (add(tiny_tuple::get<Is>(data), static_cast<uint32_t>(Is)), ...);
+        matcher.build();
+    }
+    template <size_t... Is>
+    static constexpr auto make_actions(std::index_sequence<Is...>)
+    {
+        return std::array<void (*)(extractor&, ev_t const&), sizeof...(Ts)>{&call_action<Is>...};
+    }
+    static constexpr auto actions = make_actions(std::index_sequence_for<Ts...>{});
+    static constexpr std::array<bool, sizeof...(Ts)> arena_actions{takes_arena<std::decay_t<Ts>, Traits>::value...};
 };
 
 }  // namespace detail
@@ -168,6 +219,23 @@ constexpr auto assign_string(T& ref)
     };
 }
 
+/// stores a view of the selected string, it points into the arena of the extractor and stays valid until reset()
+inline auto assign_view(std::string_view& ref)
+{
+    return [&ref](auto const& ev, string_arena& arena) {
+        if (ev.event == saj_event::string_value_end) ref = arena.current();
+    };
+}
+
+/// appends views of the selected strings, they point into the arena of the extractor and stay valid until reset()
+template <typename C>
+auto append_views(C& views)
+{
+    return [&views](auto const& ev, string_arena& arena) {
+        if (ev.event == saj_event::string_value_end) views.push_back(arena.current());
+    };
+}
+
 template <typename T>
 constexpr auto assign_name(T& ref)
 {
@@ -177,12 +245,19 @@ constexpr auto assign_name(T& ref)
     };
 }
 
+/// selects the values reached through member names, arbitrary, index, slice and each; arrays that are not addressed by one
+/// of the element selectors are transparent
 template <typename A, typename... Ts>
 constexpr auto path(A&& a, Ts&&... ts) noexcept
 {
-    return [path_test = async_json::is_path(detail::path_element(std::forward<Ts>(ts))...), a](auto ev) mutable {
-        if (path_test(ev)) a(ev);
-    };
+    return detail::path_descriptor<std::decay_t<A>, sizeof...(Ts)>{std::forward<A>(a), {{detail::path_element(std::forward<Ts>(ts))...}}};
+}
+
+/// selects the values of a path compiled with compile_json_pointer or compile_json_path
+template <typename A>
+auto path(A&& a, compiled_path compiled) noexcept
+{
+    return detail::compiled_path_descriptor<std::decay_t<A>>{std::forward<A>(a), std::move(compiled)};
 }
 
 template <typename EH, typename... Ts>
@@ -195,7 +270,7 @@ constexpr auto make_extractor(EH&& eh, Ts&&... ts) noexcept
 template <typename OtherTraits, typename EH, typename... Ts>
 constexpr auto make_extractor(EH&& eh, Ts&&... ts) noexcept
 {
-    return basic_json_parser<detail::extractor<OtherTraits, EH, Ts...>>(
+    return basic_json_parser<detail::extractor<OtherTraits, EH, Ts...>, OtherTraits>(
         detail::extractor<OtherTraits, EH, Ts...>(std::forward<EH>(eh), std::forward<Ts>(ts)...));
 }
 
@@ -0,0 +1,341 @@
+/* ==========================================================================
+ Copyright (c) 2019 Andreas Pokorny
+ Distributed under the Boost Software License, Version 1.0. (See accompanying
+ file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+========================================================================== */
+
+#ifndef ASYNC_JSON_JSON_VALIDATOR_HPP_INCLUDED
+#define ASYNC_JSON_JSON_VALIDATOR_HPP_INCLUDED
+
+#include <cstdint>
+#include <vector>
+#include <async_json/default_traits.hpp>
+#include <async_json/simd_scan.hpp>
+
+namespace async_json
+{
+namespace detail
+{
+// character classes of the validator, finer than char_class because keywords, escapes and numbers are checked per character
+enum class vclass : uint8_t
+{
+    space,
+    control_space,  // whitespace that must not appear unescaped in strings
+    br_open,
+    br_close,
+    idx_open,
+    idx_close,
+    colon,
+    comma,
+    quot,
+    escape,
+    slash,
+    plus,
+    minus,
+    dot,
+    zero,
+    digit,
+    a,
+    b,
+    c,
+    d,
+    e,
+    f,
+    l,
+    n,
+    r,
+    s,
+    t,
+    u,
+    hex_upper,  // ABCDF
+    exponent_upper,
+    other,
+    control,
+    count
+};
+
+struct vclass_table
+{
+    vclass classes[256];
+    constexpr vclass_table() : classes{}
+    {
+        for (int c = 0; c != 256; ++c) classes[c] = c < 0x20 ? vclass::control : vclass::other;
+        for (char w : {'\t', '\n', '\r'}) set(w, vclass::control_space);
+        set(' ', vclass::space);
+        for (char d = '1'; d <= '9'; ++d) set(d, vclass::digit);
+        for (char h : {'A', 'B', 'C', 'D', 'F'}) set(h, vclass::hex_upper);
+        set('{', vclass::br_open);
+        set('}', vclass::br_close);
+        set('[', vclass::idx_open);
+        set(']', vclass::idx_close);
+        set(':', vclass::colon);
+        set(',', vclass::comma);
+        set('"', vclass::quot);
+        set('\\', vclass::escape);
+        set('/', vclass::slash);
+        set('+', vclass::plus);
+        set('-', vclass::minus);
+        set('.', vclass::dot);
+        set('0', vclass::zero);
+        set('E', vclass::exponent_upper);
+        set('a', vclass::a);
+        set('b', vclass::b);
+        set('c', vclass::c);
+        set('d', vclass::d);
+        set('e', vclass::e);
+        set('f', vclass::f);
+        set('l', vclass::l);
+        set('n', vclass::n);
+        set('r', vclass::r);
+        set('s', vclass::s);
+        set('t', vclass::t);
+        set('u', vclass::u);
+    }
+    constexpr void   set(char c, vclass vc) noexcept { classes[static_cast<uint8_t>(c)] = vc; }
+    constexpr vclass operator[](char c) const noexcept { return classes[static_cast<uint8_t>(c)]; }
+};
+
+constexpr vclass_table validator_classes{};
+
+// states of the validator followed by the actions that need the nesting stack
+enum class vstate : uint8_t
+{
+    start,           // expecting the document value
+    value_done,      // after a value
+    object_open,     // after '{'
+    key_expected,    // after ',' in an object
+    colon_expected,  // after a key
+    value_expected,  // after ':' or ',' in an array
+    array_open,      // after '['
+    string,
+    string_esc,
+    u1,
+    u2,
+    u3,
+    u4,
+    minus,
+    zero,
+    integer,
+    fraction_start,
+    fraction,
+    exponent_start,
+    exponent_sign,
+    exponent,
+    t1,  // "t" seen, the digit counts the matched characters
+    t2,
+    t3,
+    f1,
+    f2,
+    f3,
+    f4,
+    n1,
+    n2,
+    n3,
+    error,
+    push_object,
+    push_array,
+    pop_empty_object,
+    pop_object,
+    pop_array,
+    string_end,
+    next_element,
+    member_value
+};
+
+struct validator_table
+{
+    vstate next[static_cast<int>(vstate::error)][static_cast<int>(vclass::count)];
+
+    constexpr validator_table() : next{}
+    {
+        for (auto& row : next)
+            for (auto& n : row) n = vstate::error;
+        for (auto s : {vstate::start, vstate::value_done, vstate::object_open, vstate::key_expected, vstate::colon_expected,
+                       vstate::value_expected, vstate::array_open})
+        {
+            set(s, vclass::space, s);
+            set(s, vclass::control_space, s);
+        }
+        for (auto s : {vstate::start, vstate::value_expected, vstate::array_open})
+        {
+            set(s, vclass::br_open, vstate::push_object);
+            set(s, vclass::idx_open, vstate::push_array);
+            set(s, vclass::quot, vstate::string);
+            set(s, vclass::minus, vstate::minus);
+            set(s, vclass::zero, vstate::zero);
+            set(s, vclass::digit, vstate::integer);
+            set(s, vclass::t, vstate::t1);
+            set(s, vclass::f, vstate::f1);
+            set(s, vclass::n, vstate::n1);
+        }
+        set(vstate::array_open, vclass::idx_close, vstate::pop_array);
+        set(vstate::object_open, vclass::br_close, vstate::pop_empty_object);
+        set(vstate::object_open, vclass::quot, vstate::string);
+        set(vstate::key_expected, vclass::quot, vstate::string);
+        set(vstate::colon_expected, vclass::colon, vstate::member_value);
+        set(vstate::value_done, vclass::comma, vstate::next_element);
+        set(vstate::value_done, vclass::br_close, vstate::pop_object);
+        set(vstate::value_done, vclass::idx_close, vstate::pop_array);
+
+        for (auto& n : next[static_cast<int>(vstate::string)]) n = vstate::string;
+        set(vstate::string, vclass::control, vstate::error);
+        set(vstate::string, vclass::control_space, vstate::error);
+        set(vstate::string, vclass::quot, vstate::string_end);
+        set(vstate::string, vclass::escape, vstate::string_esc);
+        for (auto c : {vclass::quot, vclass::escape, vclass::slash, vclass::b, vclass::f, vclass::n, vclass::r, vclass::t})
+            set(vstate::string_esc, c, vstate::string);
+        set(vstate::string_esc, vclass::u, vstate::u1);
+        for (auto c : {vclass::zero, vclass::digit, vclass::a, vclass::b, vclass::c, vclass::d, vclass::e, vclass::f, vclass::hex_upper,
+                       vclass::exponent_upper})
+        {
+            set(vstate::u1, c, vstate::u2);
+            set(vstate::u2, c, vstate::u3);
+            set(vstate::u3, c, vstate::u4);
+            set(vstate::u4, c, vstate::string);
+        }
+
+        set(vstate::minus, vclass::zero, vstate::zero);
+        set(vstate::minus, vclass::digit, vstate::integer);
+        for (auto s : {vstate::zero, vstate::integer, vstate::fraction, vstate::exponent})
+        {
+            set(s, vclass::space, vstate::value_done);
+            set(s, vclass::control_space, vstate::value_done);
+            set(s, vclass::comma, vstate::next_element);
+            set(s, vclass::br_close, vstate::pop_object);
+            set(s, vclass::idx_close, vstate::pop_array);
+        }
+        for (auto s : {vstate::zero, vstate::integer})
+        {
+            set(s, vclass::dot, vstate::fraction_start);
+            set(s, vclass::e, vstate::exponent_start);
+            set(s, vclass::exponent_upper, vstate::exponent_start);
+        }
+        set(vstate::fraction, vclass::e, vstate::exponent_start);
+        set(vstate::fraction, vclass::exponent_upper, vstate::exponent_start);
+        set(vstate::exponent_start, vclass::plus, vstate::exponent_sign);
+        set(vstate::exponent_start, vclass::minus, vstate::exponent_sign);
+        for (auto c : {vclass::zero, vclass::digit})
+        {
+            set(vstate::integer, c, vstate::integer);
+            set(vstate::fraction_start, c, vstate::fraction);
+            set(vstate::fraction, c, vstate::fraction);
+            set(vstate::exponent_start, c, vstate::exponent);
+            set(vstate::exponent_sign, c, vstate::exponent);
+            set(vstate::exponent, c, vstate::exponent);
+        }
+
+        set(vstate::t1, vclass::r, vstate::t2);
+        set(vstate::t2, vclass::u, vstate::t3);
+        set(vstate::t3, vclass::e, vstate::value_done);
+        set(vstate::f1, vclass::a, vstate::f2);
+        set(vstate::f2, vclass::l, vstate::f3);
+        set(vstate::f3, vclass::s, vstate::f4);
+        set(vstate::f4, vclass::e, vstate::value_done);
+        set(vstate::n1, vclass::u, vstate::n2);
+        set(vstate::n2, vclass::l, vstate::n3);
+        set(vstate::n3, vclass::l, vstate::value_done);
+    }
+    constexpr void   set(vstate s, vclass c, vstate n) noexcept { next[static_cast<int>(s)][static_cast<int>(c)] = n; }
+    constexpr vstate operator()(vstate s, char c) const noexcept
+    {
+        return next[static_cast<int>(s)][static_cast<int>(validator_classes[c])];
+    }
+};
+
+constexpr validator_table validator_transitions{};
+}  // namespace detail
+
+/// Checks input against the JSON grammar without reporting any events. Keeps nothing but the DFA state and the nesting
+/// stack, so it is much cheaper than basic_json_parser with a default_handler. Unlike the parser it is strict: no
+/// leading zeros, no whitespace after '-', no '\b' as whitespace and no unescaped control characters in strings.
+template <typename Traits = default_traits>
+struct basic_json_validator
+{
+    using sv_t = typename Traits::sv_t;
+
+   private:
+    enum class mode : uint8_t
+    {
+        done,
+        key,
+        object,
+        array
+    };
+    detail::vstate    current{detail::vstate::start};
+    std::vector<mode> stack{mode::done};
+
+    detail::vstate act(detail::vstate action) noexcept
+    {
+        using detail::vstate;
+        auto const top = stack.back();
+        switch (action)
+        {
+            case vstate::push_object: stack.push_back(mode::key); return vstate::object_open;
+            case vstate::push_array: stack.push_back(mode::array); return vstate::array_open;
+            case vstate::pop_empty_object: stack.pop_back(); return vstate::value_done;
+            case vstate::pop_object:
+                if (top != mode::object) return vstate::error;
+                stack.pop_back();
+                return vstate::value_done;
+            case vstate::pop_array:
+                if (top != mode::array) return vstate::error;
+                stack.pop_back();
+                return vstate::value_done;
+            case vstate::string_end: return top == mode::key ? vstate::colon_expected : vstate::value_done;
+            case vstate::next_element:
+                if (top == mode::array) return vstate::value_expected;
+                if (top != mode::object) return vstate::error;
+                stack.back() = mode::key;
+                return vstate::key_expected;
+            case vstate::member_value: stack.back() = mode::object; return vstate::value_expected;
+            default: return action;
+        }
+    }
+
+   public:
+    /// consumes the next part of the document, false once the input seen so far is not the beginning of a valid document
+    bool parse_bytes(sv_t const& input)
+    {
+        using detail::vstate;
+        auto it  = input.data();
+        auto end = it + input.size();
+        for (; it != end && current != vstate::error; ++it)
+        {
+            if (current == vstate::string)
+            {
+                it = detail::find_string_special(it, end);
+                if (it == end) break;
+            }
+            current = detail::validator_transitions(current, *it);
+            if (current > vstate::error) current = act(current);
+        }
+        return current != vstate::error;
+    }
+
+    /// true when the input seen so far is a complete document, a number at the very end needs no terminating whitespace
+    bool complete() const noexcept
+    {
+        using detail::vstate;
+        return stack.size() == 1 && (current == vstate::value_done || current == vstate::zero || current == vstate::integer ||
+                                     current == vstate::fraction || current == vstate::exponent);
+    }
+
+    void reset()
+    {
+        current = detail::vstate::start;
+        stack.assign(1, mode::done);
+    }
+};
+
+using json_validator = basic_json_validator<>;
+
+/// true when document is exactly one valid JSON value surrounded by optional whitespace
+template <typename Traits = default_traits>
+bool validate(typename Traits::sv_t const& document)
+{
+    basic_json_validator<Traits> validator;
+    return validator.parse_bytes(document) && validator.complete();
+}
+}  // namespace async_json
+
+#endif
@@ -0,0 +1,99 @@
+/* ==========================================================================
+ Copyright (c) 2019 Andreas Pokorny
+ Distributed under the Boost Software License, Version 1.0. (See accompanying
+ file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+========================================================================== */
+
+#ifndef ASYNC_JSON_NUMBER_CONVERTER_HPP_INCLUDED
+#define ASYNC_JSON_NUMBER_CONVERTER_HPP_INCLUDED
+
+#include <cfloat>
+#include <charconv>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+namespace async_json
+{
+namespace detail
+{
+/// number of decimal digits that always fit into the unsigned long long mantissa accumulator
+constexpr int max_mantissa_digits = 19;
+
+/// largest k for which 10^k is exactly representable with the given number of mantissa bits (5^k < 2^bits)
+constexpr int max_exact_pow10(int mantissa_bits) noexcept
+{
+    unsigned long long const limit = mantissa_bits >= 64 ? ~0ull : (1ull << mantissa_bits) - 1;
+    unsigned long long       p     = 1;
+    int                      k     = 0;
+    while (p <= limit / 5) p *= 5, ++k;
+    return k;
+}
+
+template <typename F>
+struct exact_powers_of_ten
+{
+    static constexpr int                max_exponent = max_exact_pow10(std::numeric_limits<F>::digits);
+    static constexpr unsigned long long max_mantissa =
+        std::numeric_limits<F>::digits >= 64 ? ~0ull : (1ull << std::numeric_limits<F>::digits);
+
+    F values[max_exponent + 1];
+    constexpr exact_powers_of_ten() : values{}
+    {
+        F p = 1;
+        for (auto& v : values) v = p, p *= 10;
+    }
+};
+
+inline float       parse_c_float(char const* str, float) noexcept { return std::strtof(str, nullptr); }
+inline double      parse_c_float(char const* str, double) noexcept { return std::strtod(str, nullptr); }
+inline long double parse_c_float(char const* str, long double) noexcept { return std::strtold(str, nullptr); }
+
+/// correctly rounded conversion of the significant digits times 10^exp10, digits is left unchanged
+template <typename F>
+F decimal_to_float(std::string& digits, long exp10)
+{
+    // integer significand and exponent only, so the conversion does not depend on the locale radix character
+    char       exponent[24] = {'e'};
+    auto const res          = std::to_chars(exponent + 1, exponent + sizeof exponent, exp10);
+    auto const size         = digits.size();
+    digits.append(exponent, res.ptr);
+    F const ret = parse_c_float(digits.c_str(), F{});
+    digits.resize(size);
+    return ret;
+}
+
+/// correctly rounded conversion of mantissa * 10^exp10
+template <typename F>
+F decimal_to_float(unsigned long long mantissa, long exp10)
+{
+    using powers = exact_powers_of_ten<F>;
+    static constexpr powers pow10{};
+    if (mantissa == 0) return F(0);
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    // Clinger's fast path: both operands are exact, so the single rounding step of the IEEE operation is the correct one
+    if (mantissa <= powers::max_mantissa)
+    {
+        if (exp10 < 0)
+        {
+            if (-exp10 <= powers::max_exponent) return static_cast<F>(mantissa) / pow10.values[-exp10];
+        }
+        else
+        {
+            // move surplus powers into the mantissa while it stays exact: 12e25 -> 12000e22
+            while (exp10 > powers::max_exponent && mantissa <= powers::max_mantissa / 10) mantissa *= 10, --exp10;
+            if (exp10 <= powers::max_exponent) return static_cast<F>(mantissa) * pow10.values[exp10];
+        }
+    }
+#endif
+    char buffer[48];
+    auto res = std::to_chars(buffer, buffer + max_mantissa_digits + 1, mantissa);
+    *res.ptr++ = 'e';
+    res        = std::to_chars(res.ptr, buffer + sizeof buffer - 1, exp10);
+    *res.ptr   = 0;
+    return parse_c_float(buffer, F{});
+}
+}  // namespace detail
+}  // namespace async_json
+
+#endif
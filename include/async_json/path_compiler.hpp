@@ -0,0 +1,224 @@
+/* ==========================================================================
+ Copyright (c) 2019 Andreas Pokorny
+ Distributed under the Boost Software License, Version 1.0. (See accompanying
+ file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+========================================================================== */
+
+#ifndef ASYNC_JSON_PATH_COMPILER_HPP_INCLUDED
+#define ASYNC_JSON_PATH_COMPILER_HPP_INCLUDED
+
+#include <async_json/is_path.hpp>
+#include <algorithm>
+#include <charconv>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace async_json
+{
+namespace detail
+{
+class path_builder;
+}
+
+/// Path elements compiled from a JSON Pointer or JSONPath expression. The member names the elements refer to are owned
+/// by a shared immutable block, so copies are cheap and a compiled path can be cached and passed to any number of
+/// extractors.
+class compiled_path
+{
+   public:
+    using const_iterator = detail::path_element const*;
+
+    const_iterator begin() const noexcept { return data ? data->elements.data() : nullptr; }
+    const_iterator end() const noexcept { return data ? data->elements.data() + data->elements.size() : nullptr; }
+    size_t         size() const noexcept { return data ? data->elements.size() : 0; }
+    bool           empty() const noexcept { return size() == 0; }
+
+   private:
+    struct storage
+    {
+        std::string                       names;
+        std::vector<detail::path_element> elements;
+    };
+    std::shared_ptr<storage const> data;
+
+    explicit compiled_path(std::shared_ptr<storage const> d) : data{std::move(d)} {}
+    friend class detail::path_builder;
+};
+
+namespace detail
+{
+class path_builder
+{
+    std::string                            names;
+    std::vector<path_element>              elements;
+    std::vector<std::pair<size_t, size_t>> name_spans;  // offset and size of each member name in names
+
+   public:
+    /// member name, that also selects array elements in [first, last) when the range is not empty
+    void add_name(std::string const& name, size_t first = 0, size_t last = 0)
+    {
+        name_spans.emplace_back(names.size(), name.size());
+        names += name;
+        elements.emplace_back(std::string_view{});
+        elements.back().first = first;
+        elements.back().last  = last;
+    }
+    void add(path_element const& pe)
+    {
+        name_spans.emplace_back(0, 0);
+        elements.push_back(pe);
+    }
+    compiled_path finish()
+    {
+        auto data = std::make_shared<compiled_path::storage>();
+        data->names.swap(names);
+        data->elements.swap(elements);
+        for (size_t i = 0; i != name_spans.size(); ++i)
+            if (data->elements[i].type == path_type::string)
+                data->elements[i].str = std::string_view(data->names.data() + name_spans[i].first, name_spans[i].second);
+        return compiled_path(std::move(data));
+    }
+};
+
+/// the JSONPath wildcard: any member name or array element
+inline path_element wildcard()
+{
+    path_element pe{path_type::arbitrary};
+    pe.last = ~size_t{0};
+    return pe;
+}
+
+inline bool parse_size(std::string_view const& text, size_t& value)
+{
+    auto const res = std::from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && res.ec == std::errc{} && res.ptr == text.data() + text.size();
+}
+
+/// RFC 6901 array index: "0" or a decimal number without leading zeros
+inline bool parse_array_index(std::string const& token, size_t& index)
+{
+    if (token.empty() || (token.size() > 1 && token[0] == '0')) return false;
+    for (char c : token)
+        if (c < '0' || c > '9') return false;
+    return parse_size(token, index) && index != ~size_t{0};
+}
+}  // namespace detail
+
+/// Compiles an RFC 6901 JSON Pointer like "/a/b~1c/0". Tokens that are valid array indices select both the member of that
+/// name and the array element at that index, as the pointer cannot tell them apart. Returns nothing for malformed input.
+inline std::optional<compiled_path> compile_json_pointer(std::string_view const& pointer)
+{
+    detail::path_builder builder;
+    if (!pointer.empty() && pointer.front() != '/') return std::nullopt;
+    std::string token;
+    size_t      pos = 0;
+    while (pos != pointer.size())
+    {
+        token.clear();
+        for (++pos; pos != pointer.size() && pointer[pos] != '/'; ++pos)
+        {
+            char c = pointer[pos];
+            if (c == '~')
+            {
+                if (++pos == pointer.size() || (pointer[pos] != '0' && pointer[pos] != '1')) return std::nullopt;
+                c = pointer[pos] == '0' ? '~' : '/';
+            }
+            token += c;
+        }
+        size_t position;
+        if (detail::parse_array_index(token, position))
+            builder.add_name(token, position, position + 1);
+        else
+            builder.add_name(token);
+    }
+    return builder.finish();
+}
+
+/**
+ * Compiles a JSONPath expression of the subset
+ *   $            the document
+ *   .name        member
+ *   ['name']     member, also with double quotes and backslash escapes
+ *   .* and [*]   any member or array element
+ *   [n]          array element
+ *   [a:b]        array elements in [a, b), both bounds are optional
+ *   ..name, ..*, ..[...]  recursive descent: the selector applied to the current value and all values nested in it
+ * Filters, unions and negative indices are not supported. Returns nothing for malformed or unsupported input.
+ */
+inline std::optional<compiled_path> compile_json_path(std::string_view const& path)
+{
+    detail::path_builder builder;
+    if (path.empty() || path.front() != '$') return std::nullopt;
+    std::string name;
+    size_t      pos = 1;
+    while (pos != path.size())
+    {
+        if (path[pos] == '.')
+        {
+            if (++pos == path.size()) return std::nullopt;
+            if (path[pos] == '.')
+            {
+                builder.add(descendants);
+                if (++pos == path.size() || path[pos] == '.') return std::nullopt;
+                if (path[pos] == '[') continue;
+            }
+            if (path[pos] == '*')
+            {
+                builder.add(detail::wildcard());
+                ++pos;
+                continue;
+            }
+            auto const end = std::min(path.find_first_of(".[", pos), path.size());
+            if (end == pos) return std::nullopt;
+            builder.add_name(std::string(path.substr(pos, end - pos)));
+            pos = end;
+        }
+        else if (path[pos] == '[')
+        {
+            auto const close = path.find(']', pos);
+            if (++pos >= path.size()) return std::nullopt;
+            char const c = path[pos];
+            if (c == '\'' || c == '"')
+            {
+                name.clear();
+                for (++pos; pos != path.size() && path[pos] != c; ++pos)
+                {
+                    if (path[pos] == '\\' && ++pos == path.size()) return std::nullopt;
+                    name += path[pos];
+                }
+                if (pos == path.size() || ++pos == path.size() || path[pos] != ']') return std::nullopt;
+                builder.add_name(name);
+                ++pos;
+                continue;
+            }
+            if (close == std::string_view::npos) return std::nullopt;
+            auto const inner = path.substr(pos, close - pos);
+            auto const colon = inner.find(':');
+            size_t     first = 0, last = ~size_t{0};
+            if (inner == "*")
+                builder.add(detail::wildcard());
+            else if (colon == std::string_view::npos)
+            {
+                if (!detail::parse_size(inner, first) || first == ~size_t{0}) return std::nullopt;
+                builder.add(index(first));
+            }
+            else
+            {
+                if (colon != 0 && !detail::parse_size(inner.substr(0, colon), first)) return std::nullopt;
+                if (colon + 1 != inner.size() && !detail::parse_size(inner.substr(colon + 1), last)) return std::nullopt;
+                builder.add(slice(first, last));
+            }
+            pos = close + 1;
+        }
+        else
+            return std::nullopt;
+    }
+    return builder.finish();
+}
+}  // namespace async_json
+
+#endif
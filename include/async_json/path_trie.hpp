@@ -0,0 +1,557 @@
+/* ==========================================================================
+ Copyright (c) 2019 Andreas Pokorny
+ Distributed under the Boost Software License, Version 1.0. (See accompanying
+ file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+========================================================================== */
+
+#ifndef ASYNC_JSON_PATH_TRIE_HPP_INCLUDED
+#define ASYNC_JSON_PATH_TRIE_HPP_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <async_json/default_traits.hpp>
+#include <async_json/is_path.hpp>
+#include <async_json/simd_scan.hpp>
+#include <async_json/saj_event_value.hpp>
+
+namespace async_json
+{
+namespace detail
+{
+constexpr uint64_t fnv1a_offset = 0xcbf29ce484222325ull;
+
+/// FNV-1a hash of str continuing from h, so the hash of a member name can be computed fragment by fragment
+constexpr uint64_t fnv1a(std::string_view const& str, uint64_t h = fnv1a_offset) noexcept
+{
+    for (char c : str) h = (h ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+    return h;
+}
+
+constexpr size_t dynamic_size = ~size_t{0};
+
+/// std::array with a size, the storage of tries whose size is known when the extractor is compiled
+template <typename T, size_t N>
+struct fixed_vector
+{
+    std::array<T, N> items{};
+    size_t           count{0};
+
+    constexpr size_t   size() const noexcept { return count; }
+    constexpr bool     empty() const noexcept { return count == 0; }
+    constexpr T&       operator[](size_t i) noexcept { return items[i]; }
+    constexpr T const& operator[](size_t i) const noexcept { return items[i]; }
+    constexpr T*       begin() noexcept { return items.data(); }
+    constexpr T*       end() noexcept { return items.data() + count; }
+    constexpr T const* begin() const noexcept { return items.data(); }
+    constexpr T const* end() const noexcept { return items.data() + count; }
+    constexpr T&       back() noexcept { return items[count - 1]; }
+    constexpr void     push_back(T const& t) noexcept { items[count++] = t; }
+    constexpr void     assign(size_t n, T const& t) noexcept
+    {
+        for (count = 0; count != n;) items[count++] = t;
+    }
+};
+
+template <typename T, size_t N>
+using trie_storage = std::conditional_t<N == dynamic_size, std::vector<T>, fixed_vector<T, N>>;
+
+constexpr size_t add_capacity(size_t n, size_t extra) noexcept { return n == dynamic_size ? n : n + extra; }
+constexpr size_t mul_capacity(size_t n, size_t factor) noexcept { return n == dynamic_size ? n : n * factor; }
+constexpr size_t sum_capacity(std::initializer_list<size_t> sizes) noexcept
+{
+    size_t sum = 0;
+    for (auto n : sizes) sum = n == dynamic_size ? n : add_capacity(sum, n);
+    return sum;
+}
+
+/**
+ * Prefix tree over the elements of several paths, each path attaches its action id to the node of its last element.
+ * A node keeps the path element that selects it, a selector may match member names, array elements or both. All nodes
+ * and actions live in flat arrays. With MaxElements and MaxActions given these are fixed size arrays, so building the trie
+ * of an extractor does not allocate. The children selected by member names share one hash and displace perfect hash table
+ * keyed by parent node and name hash, build() has to be called after the last insert.
+ */
+template <size_t MaxElements = dynamic_size, size_t MaxActions = dynamic_size>
+struct path_trie
+{
+    // child lists are linked through node indices, 0 ends a list because the root is never a child
+    struct node
+    {
+        path_element selector{path_type::arbitrary};
+        uint64_t     hash{0};  // fnv1a of selector.str
+        uint32_t     parent{0};
+        uint32_t     first_child{0};
+        uint32_t     next_sibling{0};
+        uint32_t     next_same_name{0};  // further children of parent selected by the same member name
+        uint32_t     next_same_key{0};   // further name heads compared by match_member after this one, see build()
+        uint32_t     first_arbitrary{0};
+        uint32_t     next_arbitrary{0};
+        uint32_t     first_element{0};  // children that select array elements
+        uint32_t     next_element{0};
+        uint32_t     descendants{0};   // the child selected by descendants
+        uint32_t     first_action{0};  // 1 based index into actions, 0 when no path ends here
+        uint32_t     last_action{0};   //
+        bool         has_members{false};
+        bool         name_head{false};  // first child of parent with this member name, the one in the hash table
+    };
+    struct action_entry
+    {
+        uint32_t action;
+        uint32_t next;  // 1 based index of the next action of the same node
+    };
+    static constexpr uint32_t root             = 0;
+    static constexpr uint32_t no_member        = ~0u;
+    static constexpr uint32_t chained_bucket   = 1u << 31;  // displacement flag, the low bits are the first node of the chain
+    static constexpr uint32_t max_displacement = 1024;
+
+    trie_storage<node, add_capacity(MaxElements, 1)>                      nodes;
+    trie_storage<action_entry, MaxActions>                                actions;
+    trie_storage<uint32_t, add_capacity(mul_capacity(MaxElements, 2), 1)> displacements;  // per bucket, buckets >= names
+    trie_storage<uint32_t, add_capacity(mul_capacity(MaxElements, 4), 2)> slots;          // node index or no_member
+    uint32_t                                                              names{0};
+    uint8_t                                                               slot_bits{1};
+
+    constexpr path_trie() { nodes.push_back(node{}); }
+
+    template <typename It>
+    constexpr void insert(It first, It last, uint32_t action)
+    {
+        uint32_t current = root;
+        for (; first != last; ++first) current = add_child(current, *first);
+        actions.push_back(action_entry{action, 0});
+        auto const entry = static_cast<uint32_t>(actions.size());
+        auto&      n     = nodes[current];
+        if (n.last_action)
+            actions[n.last_action - 1].next = entry;
+        else
+            n.first_action = entry;
+        n.last_action = entry;
+    }
+
+    /// hash and displace: names are grouped into buckets by their low key bits, each bucket, largest first, gets the first
+    /// displacement that moves all of its names to free slots; with twice as many slots as names this terminates quickly.
+    /// Names with equal keys, after an FNV-1a collision for example, cannot be told apart by any displacement, so only the
+    /// first of them takes a slot and the others are chained behind it. A bucket that finds no displacement below
+    /// max_displacement is not placed at all, all its names are chained instead. With fixed size storage the table can be
+    /// built in a constant expression.
+    constexpr void build()
+    {
+        uint32_t buckets = 1;
+        uint8_t  bits    = 1;
+        while (buckets < names) buckets <<= 1;
+        while ((1u << bits) < 2 * names) ++bits;
+        slot_bits = bits;
+        slots.assign(size_t{1} << bits, no_member);
+        displacements.assign(buckets, 0);
+
+        trie_storage<uint32_t, add_capacity(mul_capacity(MaxElements, 2), 2)> bucket_start;
+        trie_storage<uint32_t, add_capacity(mul_capacity(MaxElements, 2), 1)> order;
+        trie_storage<uint32_t, add_capacity(mul_capacity(MaxElements, 2), 1)> sizes;  // names of each bucket that need a slot
+        trie_storage<uint32_t, MaxElements>                                   grouped;
+        bucket_start.assign(buckets + 1, 0);
+        sizes.assign(buckets, 0);
+        grouped.assign(names, 0);
+        auto const count  = static_cast<uint32_t>(nodes.size());
+        auto       key_of = [&](uint32_t n) { return key(nodes[n].parent, nodes[n].hash); };
+        for (uint32_t n = 0; n != count; ++n)
+            if (nodes[n].name_head) ++bucket_start[(key_of(n) & (buckets - 1)) + 1];
+        for (uint32_t b = 0; b != buckets; ++b) bucket_start[b + 1] += bucket_start[b];
+        // counting sort of the names by bucket, displacements serve as fill counters until the search below
+        for (uint32_t n = 0; n != count; ++n)
+        {
+            if (!nodes[n].name_head) continue;
+            auto const b                                  = key_of(n) & (buckets - 1);
+            grouped[bucket_start[b] + displacements[b]++] = n;
+            nodes[n].next_same_key                        = 0;
+        }
+        // names with the key of an earlier name in the bucket are chained behind that one and leave the bucket
+        for (uint32_t b = 0; b != buckets; ++b)
+        {
+            auto end = bucket_start[b];
+            for (auto i = bucket_start[b]; i != bucket_start[b + 1]; ++i)
+            {
+                auto const n = grouped[i];
+                auto       j = bucket_start[b];
+                while (j != end && key_of(grouped[j]) != key_of(n)) ++j;
+                if (j == end)
+                    grouped[end++] = n;
+                else
+                {
+                    nodes[n].next_same_key          = nodes[grouped[j]].next_same_key;
+                    nodes[grouped[j]].next_same_key = n;
+                }
+            }
+            sizes[b] = end - bucket_start[b];
+        }
+        // counting sort of the buckets by descending size, std::sort is not constexpr before C++20
+        auto size_of = [&](uint32_t b) { return sizes[b]; };
+        trie_storage<uint32_t, add_capacity(MaxElements, 2)> by_size;
+        by_size.assign(names + 2, 0);
+        for (uint32_t b = 0; b != buckets; ++b) ++by_size[names - size_of(b) + 1], displacements[b] = 0;
+        for (uint32_t k = 0; k != names + 1; ++k) by_size[k + 1] += by_size[k];
+        order.assign(buckets, 0);
+        for (uint32_t b = 0; b != buckets; ++b) order[by_size[names - size_of(b)]++] = b;
+
+        auto slot_for = [&](uint32_t i, uint32_t d) { return slot_of(key_of(grouped[i]), d, bits); };
+        for (auto b : order)
+        {
+            if (size_of(b) == 0) break;
+            auto const first = bucket_start[b];
+            auto const last  = first + size_of(b);
+            uint32_t   d     = 0;
+            for (; d != max_displacement; ++d)
+            {
+                auto i = first;
+                for (; i != last; ++i)
+                {
+                    auto const s = slot_for(i, d);
+                    if (slots[s] != no_member) break;
+                    slots[s] = grouped[i];
+                }
+                if (i == last) break;
+                while (i-- != first) slots[slot_for(i, d)] = no_member;
+            }
+            if (d != max_displacement)
+            {
+                displacements[b] = d;
+                continue;
+            }
+            for (auto i = first; i + 1 != last; ++i)
+            {
+                auto tail = grouped[i];
+                while (nodes[tail].next_same_key) tail = nodes[tail].next_same_key;
+                nodes[tail].next_same_key = grouped[i + 1];
+            }
+            displacements[b] = chained_bucket | grouped[first];
+        }
+    }
+
+    /// calls f with the id of every path that ends at node n
+    template <typename F>
+    constexpr void for_each_action(uint32_t n, F&& f) const
+    {
+        for (auto a = nodes[n].first_action; a; a = actions[a - 1].next) f(actions[a - 1].action);
+    }
+
+    /// calls f with every child of n that selects the array element at position i
+    template <typename F>
+    void match_element(uint32_t n, size_t i, F&& f) const
+    {
+        for (auto c = nodes[n].first_element; c; c = nodes[c].next_element)
+            if (nodes[c].selector.first <= i && i < nodes[c].selector.last) f(c);
+    }
+
+    /// true when n has children reached by member names
+    bool has_members(uint32_t n) const noexcept { return nodes[n].has_members; }
+    /// true when n has children reached by array elements
+    bool has_elements(uint32_t n) const noexcept { return nodes[n].first_element != 0; }
+    /// the child of n selected by descendants or 0
+    uint32_t descendants_of(uint32_t n) const noexcept { return nodes[n].descendants; }
+    /// true when n is selected by descendants and thus stays selected in every nested value
+    bool is_descendants(uint32_t n) const noexcept { return nodes[n].selector.type == path_type::descendants; }
+
+    /// calls f with every child of n that a member called name with the given fnv1a hash leads to
+    template <typename F>
+    void match_member(uint32_t n, uint64_t hash, std::string_view const& name, F&& f) const
+    {
+        if (names)
+        {
+            auto const k = key(n, hash);
+            auto const d = displacements[k & (displacements.size() - 1)];
+            auto       m = d & chained_bucket ? d & ~chained_bucket : slots[slot_of(k, d, slot_bits)];
+            for (m = m == no_member ? 0 : m; m; m = nodes[m].next_same_key)
+            {
+                auto const& c = nodes[m];
+                if (c.parent == n && c.hash == hash && c.selector.str.size() == name.size() &&
+                    equal_bytes(c.selector.str.data(), name.data(), name.size()))
+                {
+                    for (auto same = m; same; same = nodes[same].next_same_name) f(same);
+                    break;
+                }
+            }
+        }
+        for (auto a = nodes[n].first_arbitrary; a; a = nodes[a].next_arbitrary) f(a);
+    }
+
+   private:
+    static constexpr uint64_t key(uint32_t parent, uint64_t hash) noexcept { return hash ^ (parent * 0x9e3779b97f4a7c15ull); }
+    static constexpr uint32_t slot_of(uint64_t k, uint32_t displacement, uint8_t bits) noexcept
+    {
+        return static_cast<uint32_t>(((k ^ (displacement * 0xc2b2ae3d27d4eb4full)) * 0xff51afd7ed558ccdull) >> (64 - bits));
+    }
+    static constexpr bool same_selector(path_element const& l, path_element const& r) noexcept
+    {
+        return l.type == r.type && l.str == r.str && l.first == r.first && l.last == r.last;
+    }
+
+    constexpr uint32_t add_child(uint32_t parent, path_element const& pe)
+    {
+        uint32_t head = 0;
+        for (auto c = nodes[parent].first_child; c; c = nodes[c].next_sibling)
+        {
+            if (same_selector(nodes[c].selector, pe)) return c;
+            if (nodes[c].name_head && pe.type == path_type::string && nodes[c].selector.str == pe.str) head = c;
+        }
+        auto const child = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(node{});
+        auto& n        = nodes[child];
+        auto& p        = nodes[parent];
+        n.selector     = pe;
+        n.parent       = parent;
+        n.next_sibling = p.first_child;
+        p.first_child  = child;
+        if (pe.type == path_type::string)
+        {
+            n.hash        = fnv1a(pe.str);
+            p.has_members = true;
+            if (head)
+            {
+                n.next_same_name           = nodes[head].next_same_name;
+                nodes[head].next_same_name = child;
+            }
+            else
+            {
+                n.name_head = true;
+                ++names;
+            }
+        }
+        else if (pe.type == path_type::arbitrary)
+        {
+            p.has_members     = true;
+            n.next_arbitrary  = p.first_arbitrary;
+            p.first_arbitrary = child;
+        }
+        else if (pe.type == path_type::descendants)
+            p.descendants = child;
+        if (pe.first != pe.last)
+        {
+            n.next_element  = p.first_element;
+            p.first_element = child;
+        }
+        return child;
+    }
+};
+
+/**
+ * Runs all paths of a path_trie against one saj event stream. Every open container keeps the set of trie nodes it was
+ * reached by, so each event costs a lookup in the children of those nodes instead of one state machine step per path.
+ * Array elements are matched against the element children of the array nodes, arrays are transparent for nodes with
+ * member children. A node selected by descendants is also selected wherever its parent is and stays selected in every
+ * nested value. Each node is kept at most once per level, so the state stays bounded by the depth times the trie size. All
+ * events of a value that ends a path, nested events included, are passed to the actions of that path. process_event
+ * answers parse_verdict::skip for values no path can reach.
+ */
+template <typename Traits, typename Trie = path_trie<>>
+class path_matcher
+{
+    using ev_t = saj_event_value<Traits>;
+    struct frame
+    {
+        uint32_t nodes_begin;    // range in active, the nodes this container was reached by
+        uint32_t nodes_end;      //
+        uint32_t members_begin;  // start of the nodes of the current member or element in active
+        uint32_t deliver_end;    // size of delivering inside this container
+        uint32_t index;          // position of the next array element
+        bool     array;
+    };
+
+    Trie                  trie;
+    std::vector<uint32_t> active;
+    std::vector<uint32_t> delivering;  // actions that receive the current event
+    std::vector<frame>    frames{frame{0, 0, 0, 0, 0, false}};  // the document behaves like an object whose member matched the root
+    std::string           name_buffer;
+    std::string_view      name;
+    uint64_t              name_hash{fnv1a_offset};
+    bool                  split_name{false};  // name_buffer holds the name
+    bool                  in_name{false};
+    uint32_t              string_deliver_end{0};
+
+    template <typename F>
+    void notify(uint32_t deliver_end, ev_t const& ev, F& deliver)
+    {
+        for (uint32_t i = 0; i != deliver_end; ++i) deliver(delivering[i], ev);
+    }
+
+    void add_actions(uint32_t n)
+    {
+        // a value nested in a value of the same path, reached through descendants, already delivers to that path
+        trie.for_each_action(n, [this](uint32_t a) {
+            if (std::find(delivering.begin(), delivering.end(), a) == delivering.end()) delivering.push_back(a);
+        });
+    }
+
+    /// adds n and the descendants chain below it to the nodes of the current member or element unless already there
+    void select(uint32_t n)
+    {
+        for (; n; n = trie.descendants_of(n))
+        {
+            auto const begin = active.begin() + frames.back().members_begin;
+            if (std::find(begin, active.end(), n) != active.end()) return;
+            active.push_back(n);
+        }
+    }
+
+    /// true when the value or container that starts now neither leads to nor is part of a selected value
+    bool unreachable() const
+    {
+        return frames.back().members_begin == active.size() && delivering.empty();
+    }
+
+    parse_verdict match_member(std::string_view const& member)
+    {
+        auto const& top = frames.back();
+        active.resize(top.members_begin);
+        for (auto i = top.nodes_begin; i != top.nodes_end; ++i)
+        {
+            if (trie.is_descendants(active[i])) select(active[i]);
+            trie.match_member(active[i], name_hash, member, [this](uint32_t n) { select(n); });
+        }
+        return active.size() == top.members_begin && top.deliver_end == 0 ? parse_verdict::skip : parse_verdict::proceed;
+    }
+
+    /// selects the nodes of the value that starts now and adds the actions of the paths ending there
+    uint32_t begin_value()
+    {
+        auto& top = frames.back();
+        delivering.resize(top.deliver_end);
+        if (top.array)
+        {
+            auto const i = top.index++;
+            active.resize(top.members_begin);
+            for (auto n = top.nodes_begin; n != top.nodes_end; ++n)
+            {
+                if (trie.is_descendants(active[n])) select(active[n]);
+                trie.match_element(active[n], i, [this](uint32_t e) { select(e); });
+            }
+            auto const selected = active.size();
+            for (auto n = top.members_begin; n != selected; ++n) add_actions(active[n]);
+            // nodes passed through the array only to reach members of its elements
+            for (auto n = top.nodes_begin; n != top.nodes_end; ++n)
+                if (trie.has_members(active[n]) && std::find(active.begin() + top.members_begin, active.end(), active[n]) == active.end())
+                    active.push_back(active[n]);
+        }
+        else
+            for (auto n = top.members_begin; n != active.size(); ++n) add_actions(active[n]);
+        return static_cast<uint32_t>(delivering.size());
+    }
+
+    void end_value()
+    {
+        auto const& top = frames.back();
+        delivering.resize(top.deliver_end);
+        if (frames.size() > 1) active.resize(top.members_begin);
+    }
+
+    void push_frame(bool array, uint32_t deliver_end)
+    {
+        auto const nodes_begin = frames.back().members_begin;
+        auto const nodes_end   = static_cast<uint32_t>(active.size());
+        frames.push_back(frame{nodes_begin, nodes_end, nodes_end, deliver_end, 0, array});
+    }
+
+    void pop_frame()
+    {
+        if (frames.size() > 1) frames.pop_back();
+        end_value();
+    }
+
+   public:
+    template <typename It>
+    void add_path(It first, It last, uint32_t action)
+    {
+        trie.insert(first, last, action);
+    }
+    /// has to be called once all paths are added
+    void build()
+    {
+        trie.build();
+        reset();
+    }
+
+    /// calls deliver(action, ev) for every path that ev belongs to
+    template <typename F>
+    parse_verdict process_event(ev_t const& ev, F&& deliver)
+    {
+        switch (ev.event)
+        {
+            case saj_event::object_name_start:
+                notify(frames.back().deliver_end, ev, deliver);
+                name       = std::string_view(ev.as_string_view().data(), ev.as_string_view().size());
+                split_name = false;
+                in_name    = true;
+                // names in containers that no path reaches are not hashed at all
+                if (frames.back().nodes_begin != frames.back().nodes_end) name_hash = fnv1a(name);
+                break;
+            case saj_event::object_name_cont:
+                notify(frames.back().deliver_end, ev, deliver);
+                if (!split_name) name_buffer.assign(name.begin(), name.end());
+                split_name = true;
+                name_buffer.append(ev.as_string_view().begin(), ev.as_string_view().end());
+                if (frames.back().nodes_begin != frames.back().nodes_end)
+                    name_hash = fnv1a(std::string_view(ev.as_string_view().data(), ev.as_string_view().size()), name_hash);
+                break;
+            case saj_event::object_name_end:
+                notify(frames.back().deliver_end, ev, deliver);
+                in_name = false;
+                return match_member(split_name ? std::string_view(name_buffer) : name);
+            case saj_event::object_start:
+            case saj_event::array_start:
+            {
+                auto const deliver_end = begin_value();
+                notify(deliver_end, ev, deliver);
+                bool const skip = frames.size() > 1 && unreachable();
+                push_frame(ev.event == saj_event::array_start, deliver_end);
+                return skip ? parse_verdict::skip : parse_verdict::proceed;
+            }
+            case saj_event::object_end:
+            case saj_event::array_end:
+                notify(frames.back().deliver_end, ev, deliver);
+                pop_frame();
+                break;
+            case saj_event::string_value_start:
+                string_deliver_end = begin_value();
+                notify(string_deliver_end, ev, deliver);
+                break;
+            case saj_event::string_value_cont: notify(string_deliver_end, ev, deliver); break;
+            case saj_event::string_value_end:
+                notify(string_deliver_end, ev, deliver);
+                end_value();
+                break;
+            case saj_event::parse_error: break;
+            default:
+                notify(begin_value(), ev, deliver);
+                end_value();
+                break;
+        }
+        return parse_verdict::proceed;
+    }
+
+    /// copies the start of a name that continues in the next input buffer, names within one buffer are never copied
+    void chunk_end()
+    {
+        if (!in_name || split_name) return;
+        name_buffer.assign(name.begin(), name.end());
+        split_name = true;
+    }
+
+    void reset()
+    {
+        delivering.clear();
+        frames.resize(1);
+        active.assign(1, Trie::root);
+        select(trie.descendants_of(Trie::root));
+        split_name = false;
+        in_name    = false;
+    }
+};
+}  // namespace detail
+}  // namespace async_json
+
+#endif
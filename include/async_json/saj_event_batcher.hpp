@@ -0,0 +1,115 @@
+/* ==========================================================================
+ Copyright (c) 2019 Andreas Pokorny
+ Distributed under the Boost Software License, Version 1.0. (See accompanying
+ file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+========================================================================== */
+
+#ifndef ASYNC_JSON_SAJ_EVENT_BATCHER_H
+#define ASYNC_JSON_SAJ_EVENT_BATCHER_H
+
+#include <array>
+#include <cstddef>
+#include <async_json/basic_json_parser.hpp>
+#include <async_json/saj_event_value.hpp>
+#include <async_json/string_arena.hpp>
+
+namespace async_json
+{
+/// read only view of consecutive events
+template <typename Traits>
+struct saj_event_batch
+{
+    using value_type = saj_event_value<Traits>;
+    value_type const* first{nullptr};
+    size_t            count{0};
+
+    constexpr value_type const* begin() const noexcept { return first; }
+    constexpr value_type const* end() const noexcept { return first + count; }
+    constexpr size_t            size() const noexcept { return count; }
+    constexpr bool              empty() const noexcept { return count == 0; }
+    constexpr value_type const& operator[](size_t i) const noexcept { return first[i]; }
+};
+
+/**
+ * CRTP callback handler for the basic_json_parser, it records the events in a
+ * buffer of N saj_event_values and calls a user provided
+ * handle_batch(saj_event_batch<Traits>) method whenever the buffer is full and
+ * at the end of every parse_bytes call, so that the string views in a batch
+ * still refer to the input buffer. With Traits::contiguous_strings or
+ * Traits::decode_escapes the parser reports strings from buffers it reuses for
+ * the next string, so the batcher copies every string into its own storage
+ * until the batch is handled. */
+template <typename SMC, typename Traits = default_traits, size_t N = 128>
+struct saj_event_batcher
+{
+    using sv_t      = typename Traits::sv_t;
+    using integer_t = typename Traits::integer_t;
+    using float_t   = typename Traits::float_t;
+    using saj_value = saj_event_value<Traits>;
+
+   private:
+    static constexpr bool copy_strings = detail::uses_contiguous_strings<Traits>::value || detail::uses_decode_escapes<Traits>::value;
+
+    std::array<saj_value, N> events;
+    size_t                   count{0};
+    string_arena             strings;  // copies of the strings and numbers of the pending events
+
+    void push(saj_value const& ev)
+    {
+        events[count] = ev;
+        if (++count == N) flush();
+    }
+    template <bool Copy = copy_strings>
+    void push(saj_event ev, sv_t const& str)
+    {
+        if constexpr (Copy)
+        {
+            auto const copy = strings.store(std::string_view(str.data(), str.size()));
+            push(saj_value(ev, sv_t(copy.data(), copy.size())));
+        }
+        else
+            push(saj_value(ev, str));
+    }
+
+   public:
+    SMC& cast() { return *static_cast<SMC*>(this); }
+
+    void flush()
+    {
+        if (count) cast().handle_batch(saj_event_batch<Traits>{events.data(), count});
+        count = 0;
+        strings.reset();
+    }
+    void chunk_end() { flush(); }
+
+    void value(bool v) { push(saj_value(saj_event::boolean_value, v)); }
+    void value(float_t v) { push(saj_value(saj_event::float_value, v)); }
+    void value(integer_t v) { push(saj_value(saj_event::integer_value, v)); }
+    void value(void*) { push(saj_value()); }
+    /// the parser may report number texts from a buffer it reuses for the next number, so they are always copied
+    void number_value(sv_t const& v) { push<true>(saj_event::number_value, v); }
+    void value(sv_t const& v)
+    {
+        push(saj_event::string_value_start, v);
+        push(saj_value(saj_event::string_value_end));
+    }
+    void string_value_start(sv_t const& v) { push(saj_event::string_value_start, v); }
+    void string_value_cont(sv_t const& v) { push(saj_event::string_value_cont, v); }
+    void string_value_end() { push(saj_value(saj_event::string_value_end)); }
+    void named_object(sv_t const& name)
+    {
+        push(saj_event::object_name_start, name);
+        push(saj_value(saj_event::object_name_end));
+    }
+    void named_object_start(sv_t const& name) { push(saj_event::object_name_start, name); }
+    void named_object_cont(sv_t const& name) { push(saj_event::object_name_cont, name); }
+    void named_object_end() { push(saj_value(saj_event::object_name_end)); }
+    void object_start() { push(saj_value(saj_event::object_start)); }
+    void object_end() { push(saj_value(saj_event::object_end)); }
+    void array_start() { push(saj_value(saj_event::array_start)); }
+    void array_end() { push(saj_value(saj_event::array_end)); }
+    void error(async_json::error_cause err) { push(saj_value(saj_event::parse_error, err)); }
+};
+}  // namespace async_json
+
+#endif
@@ -35,7 +35,8 @@ constexpr auto create_saj_state_machine(Ts&&... ts) noexcept
 /**
  * CRTP callback handler for the basic_json_parser, it calls a user provided
  * process_event(saj_event_id) method. The current value is provided through
- * the various current_ members. */
+ * the various current_ members. When process_event returns a parse_verdict the
+ * callbacks that can skip input pass it on to the parser. */
 template <typename SMC, typename Traits = default_traits>
 struct saj_event_mapper
 {
@@ -61,17 +62,23 @@ struct saj_event_mapper
     void string_value_start(sv_t const& v) { cast().process_event(event_value = saj_value(saj_event::string_value_start, v)); }
     void string_value_cont(sv_t const& v) { cast().process_event(event_value = saj_value(saj_event::string_value_cont, v)); }
     void string_value_end() { cast().process_event(event_value = saj_value(saj_event::string_value_end)); }
-    void named_object(sv_t const& name)
+    decltype(auto) named_object(sv_t const& name)
     {
         cast().process_event(event_value = saj_value(saj_event::object_name_start, name));
-        cast().process_event(event_value = saj_value(saj_event::object_name_end));
+        return cast().process_event(event_value = saj_value(saj_event::object_name_end));
     }
-    void named_object_start(sv_t const& name) { cast().process_event(event_value = saj_value(saj_event::object_name_start, name)); }
-    void named_object_cont(sv_t const& name) { cast().process_event(event_value = saj_value(saj_event::object_name_cont, name)); }
-    void named_object_end() { cast().process_event(event_value = saj_value(saj_event::object_name_end)); }
-    void object_start() { cast().process_event(event_value = saj_value(saj_event::object_start)); }
-    void object_end() { cast().process_event(event_value = saj_value(saj_event::object_end)); }
-    void array_start() { cast().process_event(event_value = saj_value(saj_event::array_start)); }
+    decltype(auto) named_object_start(sv_t const& name)
+    {
+        return cast().process_event(event_value = saj_value(saj_event::object_name_start, name));
+    }
+    decltype(auto) named_object_cont(sv_t const& name)
+    {
+        return cast().process_event(event_value = saj_value(saj_event::object_name_cont, name));
+    }
+    decltype(auto) named_object_end() { return cast().process_event(event_value = saj_value(saj_event::object_name_end)); }
+    decltype(auto) object_start() { return cast().process_event(event_value = saj_value(saj_event::object_start)); }
+    void           object_end() { cast().process_event(event_value = saj_value(saj_event::object_end)); }
+    decltype(auto) array_start() { return cast().process_event(event_value = saj_value(saj_event::array_start)); }
     void array_end() { cast().process_event(event_value = saj_value(saj_event::array_end)); }
     void error(async_json::error_cause err) { cast().process_event(event_value = saj_value(saj_event::parse_error, err)); }
 };
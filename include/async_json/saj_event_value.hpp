@@ -9,7 +9,8 @@
 
 #include <type_traits>
 #include <algorithm>
-#include <variant>
+#include <cassert>
+#include <cstdint>
 #include <async_json/default_traits.hpp>  // error cause
 
 namespace async_json
@@ -34,8 +35,10 @@ constexpr std::underlying_type_t<E> cast(E v) noexcept
 {
     return static_cast<std::underlying_type_t<E>>(v);
 }
+/// number_value carries the text of a number reported through number_value(sv_t const&), only saj_event_batcher records it
 enum class saj_event : uint8_t
 {
+    number_value       = 0 + cast(saj_variant_value::string),
     null_value         = 1 + cast(saj_variant_value::none),
     integer_value      = 2 + cast(saj_variant_value::number),
     boolean_value      = 3 + cast(saj_variant_value::boolean),
@@ -53,6 +56,8 @@ enum class saj_event : uint8_t
     parse_error        = 15 + cast(saj_variant_value::error)
 };
 
+/// Event tag and value in a trivially copyable tagged union, 16 bytes with the default traits. The mask bits of event tell
+/// which member of the union is active, the accessors do not check that. String views are limited to 4 GiB.
 template <typename Traits>
 struct saj_event_value
 {
@@ -60,31 +65,44 @@ struct saj_event_value
     using integer_t = typename Traits::integer_t;
     using float_t   = typename Traits::float_t;
 
-    saj_event event{saj_event::null_value};
-    std::variant<sv_t, bool, float_t, integer_t, error_cause> store;
+    union value_store
+    {
+        char const* str;
+        bool        boolean;
+        float_t     float_number;
+        integer_t   number;
+        error_cause error;
+
+        constexpr value_store() noexcept : str{nullptr} {}
+        constexpr value_store(char const* s) noexcept : str{s} {}
+        constexpr value_store(bool b) noexcept : boolean{b} {}
+        constexpr value_store(float_t f) noexcept : float_number{f} {}
+        constexpr value_store(integer_t i) noexcept : number{i} {}
+        constexpr value_store(error_cause e) noexcept : error{e} {}
+    };
+    value_store store;
+    uint32_t    length{0};  ///< size of the string view in store.str
+    saj_event   event{saj_event::null_value};
 
-    constexpr saj_event_value()                        = default;
-    constexpr saj_event_value(saj_event_value const &) = default;
-    constexpr saj_event_value(saj_event_value &&)      = default;
-    constexpr saj_event_value &operator=(saj_event_value const &) = default;
-    constexpr saj_event_value &operator=(saj_event_value &&) = default;
+    constexpr saj_event_value() = default;
     constexpr explicit saj_event_value(saj_event ev) : event{ev} {}
-    constexpr saj_event_value(saj_event ev, float_t f) : event{ev}, store(f) {}
-    constexpr saj_event_value(saj_event ev, integer_t i) : event{ev}, store(i) {}
-    constexpr saj_event_value(saj_event ev, bool b) : event{ev}, store(b) {}
-    constexpr saj_event_value(saj_event ev, error_cause e) : event{ev}, store(e) {}
-    constexpr saj_event_value(saj_event ev, sv_t s) : event{ev}, store(s) {}
+    constexpr saj_event_value(saj_event ev, float_t f) : store{f}, event{ev} {}
+    constexpr saj_event_value(saj_event ev, integer_t i) : store{i}, event{ev} {}
+    constexpr saj_event_value(saj_event ev, bool b) : store{b}, event{ev} {}
+    constexpr saj_event_value(saj_event ev, error_cause e) : store{e}, event{ev} {}
+    constexpr saj_event_value(saj_event ev, sv_t s) : store{s.data()}, length{string_length(s.size())}, event{ev} {}
 
-    constexpr auto as_number() const noexcept { return std::get<integer_t>(store); }
-    constexpr auto as_float_number() const noexcept { return std::get<float_t>(store); }
-    constexpr auto as_string_view() const noexcept { return std::get<sv_t>(store); }
-    constexpr auto as_bool() const noexcept { return std::get<bool>(store); }
-    constexpr auto as_error_cause() const noexcept { return std::get<error_cause>(store); }
+    constexpr auto as_number() const noexcept { return store.number; }
+    constexpr auto as_float_number() const noexcept { return store.float_number; }
+    constexpr auto as_string_view() const noexcept { return sv_t(store.str, length); }
+    constexpr auto as_bool() const noexcept { return store.boolean; }
+    constexpr auto as_error_cause() const noexcept { return store.error; }
     constexpr bool is_value() const noexcept
     {
         switch (event)
         {
             case saj_event::null_value:
+            case saj_event::number_value:
             case saj_event::integer_value:
             case saj_event::boolean_value:
             case saj_event::float_value:
@@ -100,7 +118,17 @@ struct saj_event_value
         return static_cast<saj_variant_value>(cast(event) & cast(saj_variant_value::mask));
     }
     constexpr auto as_event_id() const noexcept { return cast(event) & 0xF; }
+
+   private:
+    static constexpr uint32_t string_length(size_t size) noexcept
+    {
+        assert(size <= UINT32_MAX && "saj_event_value holds string views of less than 4 GiB");
+        return static_cast<uint32_t>(size);
+    }
 };
 
+static_assert(sizeof(saj_event_value<default_traits>) == 16, "saj_event_value is 16 bytes with the default traits");
+static_assert(std::is_trivially_copyable_v<saj_event_value<default_traits>>, "saj_event_value is copied as a whole");
+
 }  // namespace async_json
 #endif
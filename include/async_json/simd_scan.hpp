@@ -0,0 +1,224 @@
+/* ==========================================================================
+ Copyright (c) 2019 Andreas Pokorny
+ Distributed under the Boost Software License, Version 1.0. (See accompanying
+ file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+========================================================================== */
+
+#ifndef ASYNC_JSON_SIMD_SCAN_HPP_INCLUDED
+#define ASYNC_JSON_SIMD_SCAN_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(ASYNC_JSON_NO_SIMD)
+#if defined(__AVX2__)
+#define ASYNC_JSON_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ASYNC_JSON_SSE2 1
+#include <emmintrin.h>
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace async_json
+{
+namespace detail
+{
+inline unsigned count_trailing_zeros(uint32_t mask) noexcept
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+inline unsigned count_trailing_zeros(uint64_t mask) noexcept
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+inline unsigned popcount(uint64_t mask) noexcept
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<unsigned>(__popcnt64(mask));
+#else
+    return static_cast<unsigned>(__builtin_popcountll(mask));
+#endif
+}
+
+constexpr uint64_t broadcast(char c) noexcept { return 0x0101010101010101ull * static_cast<uint8_t>(c); }
+
+/// sets the high bit of every byte in word that is zero
+constexpr uint64_t zero_bytes(uint64_t word) noexcept
+{
+    return (word - 0x0101010101010101ull) & ~word & 0x8080808080808080ull;
+}
+
+/// returns the first '"' or '\\' in [it, end) or end
+inline char const* find_quote_or_escape(char const* it, char const* end) noexcept
+{
+#if defined(ASYNC_JSON_AVX2)
+    __m256i const quot32 = _mm256_set1_epi8('"');
+    __m256i const esc32  = _mm256_set1_epi8('\\');
+    for (; end - it >= 32; it += 32)
+    {
+        __m256i const chunk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(it));
+        auto const    mask  = static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quot32), _mm256_cmpeq_epi8(chunk, esc32))));
+        if (mask) return it + count_trailing_zeros(mask);
+    }
+#endif
+#if defined(ASYNC_JSON_SSE2)
+    __m128i const quot = _mm_set1_epi8('"');
+    __m128i const esc  = _mm_set1_epi8('\\');
+    for (; end - it >= 16; it += 16)
+    {
+        __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(it));
+        auto const    mask =
+            static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quot), _mm_cmpeq_epi8(chunk, esc))));
+        if (mask) return it + count_trailing_zeros(mask);
+    }
+#else
+    for (; end - it >= 8; it += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, it, sizeof word);
+        if (zero_bytes(word ^ broadcast('"')) | zero_bytes(word ^ broadcast('\\'))) break;
+    }
+#endif
+    for (; it != end; ++it)
+        if (*it == '"' || *it == '\\') break;
+    return it;
+}
+
+/// returns the first '\\' in [it, end) or end
+inline char const* find_escape(char const* it, char const* end) noexcept
+{
+#if defined(ASYNC_JSON_AVX2)
+    __m256i const esc32 = _mm256_set1_epi8('\\');
+    for (; end - it >= 32; it += 32)
+    {
+        __m256i const chunk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(it));
+        auto const    mask  = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, esc32)));
+        if (mask) return it + count_trailing_zeros(mask);
+    }
+#endif
+#if defined(ASYNC_JSON_SSE2)
+    __m128i const esc = _mm_set1_epi8('\\');
+    for (; end - it >= 16; it += 16)
+    {
+        __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(it));
+        auto const    mask  = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, esc)));
+        if (mask) return it + count_trailing_zeros(mask);
+    }
+#else
+    for (; end - it >= 8; it += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, it, sizeof word);
+        if (zero_bytes(word ^ broadcast('\\'))) break;
+    }
+#endif
+    for (; it != end; ++it)
+        if (*it == '\\') break;
+    return it;
+}
+
+/// returns the first '"', '\\' or control character below 0x20 in [it, end) or end
+inline char const* find_string_special(char const* it, char const* end) noexcept
+{
+#if defined(ASYNC_JSON_SSE2)
+    __m128i const quot = _mm_set1_epi8('"');
+    __m128i const esc  = _mm_set1_epi8('\\');
+    __m128i const ctrl = _mm_set1_epi8(0x1F);
+    for (; end - it >= 16; it += 16)
+    {
+        __m128i const chunk   = _mm_loadu_si128(reinterpret_cast<__m128i const*>(it));
+        __m128i const control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, ctrl), ctrl);  // unsigned chunk <= 0x1F
+        __m128i const special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quot), _mm_cmpeq_epi8(chunk, esc)), control);
+        auto const    mask    = static_cast<uint32_t>(_mm_movemask_epi8(special));
+        if (mask) return it + count_trailing_zeros(mask);
+    }
+#endif
+    for (; it != end; ++it)
+        if (*it == '"' || *it == '\\' || static_cast<unsigned char>(*it) < 0x20) break;
+    return it;
+}
+
+/// true when the n bytes at a and b are equal, keys of up to 16 bytes are compared as two possibly overlapping words
+inline bool equal_bytes(char const* a, char const* b, size_t n) noexcept
+{
+    if (n >= 8 && n <= 16)
+    {
+        uint64_t a0, a1, b0, b1;
+        std::memcpy(&a0, a, 8);
+        std::memcpy(&b0, b, 8);
+        std::memcpy(&a1, a + n - 8, 8);
+        std::memcpy(&b1, b + n - 8, 8);
+        return ((a0 ^ b0) | (a1 ^ b1)) == 0;
+    }
+    if (n >= 4 && n < 8)
+    {
+        uint32_t a0, a1, b0, b1;
+        std::memcpy(&a0, a, 4);
+        std::memcpy(&b0, b, 4);
+        std::memcpy(&a1, a + n - 4, 4);
+        std::memcpy(&b1, b + n - 4, 4);
+        return ((a0 ^ b0) | (a1 ^ b1)) == 0;
+    }
+    if (n < 4)
+    {
+        for (size_t i = 0; i != n; ++i)
+            if (a[i] != b[i]) return false;
+        return true;
+    }
+    return std::memcmp(a, b, n) == 0;
+}
+
+constexpr bool is_whitespace(char c) noexcept { return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\b'; }
+
+/// returns the first character in [it, end) that is not one of " \n\r\t\b" or end
+inline char const* skip_whitespace(char const* it, char const* end) noexcept
+{
+    // single separating blanks are the common case, avoid the vector setup for them
+    if (it == end || !is_whitespace(*it)) return it;
+    if (++it == end || !is_whitespace(*it)) return it;
+#if defined(ASYNC_JSON_SSE2)
+    __m128i const space = _mm_set1_epi8(' ');
+    __m128i const nl    = _mm_set1_epi8('\n');
+    __m128i const cr    = _mm_set1_epi8('\r');
+    __m128i const tab   = _mm_set1_epi8('\t');
+    __m128i const bs    = _mm_set1_epi8('\b');
+    for (; end - it >= 16; it += 16)
+    {
+        __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(it));
+        __m128i const blank = _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab));
+        __m128i const eol   = _mm_or_si128(_mm_cmpeq_epi8(chunk, nl), _mm_cmpeq_epi8(chunk, cr));
+        __m128i const ws    = _mm_or_si128(_mm_or_si128(blank, eol), _mm_cmpeq_epi8(chunk, bs));
+        auto const    mask  = static_cast<uint32_t>(_mm_movemask_epi8(ws)) ^ 0xFFFFu;
+        if (mask) return it + count_trailing_zeros(mask);
+    }
+#endif
+    for (; it != end; ++it)
+        if (!is_whitespace(*it)) break;
+    return it;
+}
+}  // namespace detail
+}  // namespace async_json
+
+#endif
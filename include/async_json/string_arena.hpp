@@ -0,0 +1,94 @@
+/* ==========================================================================
+ Copyright (c) 2019 Andreas Pokorny
+ Distributed under the Boost Software License, Version 1.0. (See accompanying
+ file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+========================================================================== */
+
+#ifndef ASYNC_JSON_STRING_ARENA_HPP_INCLUDED
+#define ASYNC_JSON_STRING_ARENA_HPP_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace async_json
+{
+/**
+ * Monotonic character storage for strings that have to outlive the input buffers they arrived in. A string is built with
+ * begin() and append(), current() is the string built so far. Views into the arena stay valid until reset(). reset()
+ * merges all blocks into one block of their total size, so documents of similar size stop allocating after the first.
+ */
+class string_arena
+{
+    struct block
+    {
+        std::unique_ptr<char[]> data;
+        size_t                  size;
+    };
+    std::vector<block> blocks;
+    size_t             used{0};   // in blocks.back()
+    size_t             start{0};  // of the current string in blocks.back()
+    size_t             block_size;
+
+    /// continues in a block with room for the current string and needed more characters
+    void grow(size_t needed)
+    {
+        auto const length = used - start;
+        auto const size   = std::max(block_size, 2 * (length + needed));
+        block_size        = 2 * size;
+        block b{std::make_unique<char[]>(size), size};
+        if (length) std::memcpy(b.data.get(), blocks.back().data.get() + start, length);
+        blocks.push_back(std::move(b));
+        start = 0;
+        used  = length;
+    }
+
+   public:
+    explicit string_arena(size_t initial_block_size = 4096) : block_size{initial_block_size} {}
+
+    /// starts a new current string
+    void begin() noexcept { start = used; }
+    void append(std::string_view const& str)
+    {
+        if (blocks.empty() || blocks.back().size - used < str.size()) grow(str.size());
+        if (!str.empty()) std::memcpy(blocks.back().data.get() + used, str.data(), str.size());
+        used += str.size();
+    }
+    std::string_view current() const noexcept
+    {
+        return blocks.empty() ? std::string_view{} : std::string_view(blocks.back().data.get() + start, used - start);
+    }
+    /// copies str into the arena
+    std::string_view store(std::string_view const& str)
+    {
+        begin();
+        append(str);
+        return current();
+    }
+
+    /// invalidates all views and keeps the storage for the next document
+    void reset()
+    {
+        if (blocks.size() > 1)
+        {
+            size_t total = 0;
+            for (auto const& b : blocks) total += b.size;
+            blocks.clear();
+            blocks.push_back(block{std::make_unique<char[]>(total), total});
+        }
+        start = used = 0;
+    }
+    /// characters the arena holds without allocating
+    size_t capacity() const noexcept
+    {
+        size_t total = 0;
+        for (auto const& b : blocks) total += b.size;
+        return total;
+    }
+};
+}  // namespace async_json
+
+#endif
@@ -6,7 +6,14 @@
 
 #ifndef ASYNC_JSON_STRING_CONVERSION_HPP_INCLUDED
 #define ASYNC_JSON_STRING_CONVERSION_HPP_INCLUDED
+#include <async_json/simd_scan.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 namespace async_json
 {
 namespace detail
@@ -14,157 +21,247 @@ namespace detail
 inline bool         is_hex(char t) noexcept { return (t >= '0' && t <= '9') || (t >= 'a' && t <= 'f') || (t >= 'A' && t <= 'F'); }
 inline unsigned int from_hex(char t) noexcept
 {
-    return static_cast<unsigned int>(t - ((t >= '0' && t <= '9') ? '0' : (t >= 'a' && t <= 'f') ? 'a' : 'A'));
+    return static_cast<unsigned int>((t >= '0' && t <= '9') ? t - '0' : (t >= 'a' && t <= 'f') ? t - 'a' + 10 : t - 'A' + 10);
 }
-}  // namespace detail
-inline std::string& json_to_utf8(std::string& str)
+
+/// value of the four hex digits at text, or a value above 0xFFFF if one of them is not a hex digit
+inline uint32_t hex4(char const* text) noexcept
+{
+    uint32_t value = 0;
+    for (int i = 0; i != 4; ++i)
+    {
+        if (!is_hex(text[i])) return ~0u;
+        value = value << 4u | from_hex(text[i]);
+    }
+    return value;
+}
+
+/// passes the UTF-8 encoding of codepoint to sink(char const*, size_t)
+template <typename Sink>
+void write_utf8(uint32_t codepoint, Sink& sink)
+{
+    char   bytes[4];
+    size_t size;
+    if (codepoint < 0x80)
+    {
+        bytes[0] = static_cast<char>(codepoint);
+        size     = 1;
+    }
+    else if (codepoint < 0x800)
+    {
+        bytes[0] = static_cast<char>(0xC0u | (codepoint >> 6u));
+        bytes[1] = static_cast<char>(0x80u | (codepoint & 0x3Fu));
+        size     = 2;
+    }
+    else if (codepoint < 0x10000)
+    {
+        bytes[0] = static_cast<char>(0xE0u | (codepoint >> 12u));
+        bytes[1] = static_cast<char>(0x80u | ((codepoint >> 6u) & 0x3Fu));
+        bytes[2] = static_cast<char>(0x80u | (codepoint & 0x3Fu));
+        size     = 3;
+    }
+    else
+    {
+        bytes[0] = static_cast<char>(0xF0u | (codepoint >> 18u));
+        bytes[1] = static_cast<char>(0x80u | ((codepoint >> 12u) & 0x3Fu));
+        bytes[2] = static_cast<char>(0x80u | ((codepoint >> 6u) & 0x3Fu));
+        bytes[3] = static_cast<char>(0x80u | (codepoint & 0x3Fu));
+        size     = 4;
+    }
+    sink(bytes, size);
+}
+
+/// true if [it, end) may be the start of a "\uXXXX" sequence
+inline bool unicode_escape_prefix(char const* it, char const* end) noexcept
 {
-    enum escape_state
+    char const pattern[] = "\\uXXXX";
+    for (size_t i = 0; it != end && i != 6; ++it, ++i)
+        if (pattern[i] == 'X' ? !is_hex(*it) : *it != pattern[i]) return false;
+    return true;
+}
+
+/// decodes the \u sequence at it, a high surrogate is combined with a low surrogate sequence that follows
+template <typename Sink>
+char const* decode_unicode_escape(char const* it, char const* end, bool last, Sink& sink)
+{
+    auto const available = static_cast<size_t>(end - it);
+    if (available < 6 && !last && unicode_escape_prefix(it, end)) return it;
+    uint32_t const codepoint = available < 6 ? ~0u : hex4(it + 2);
+    if (codepoint > 0xFFFF)
     {
-        none,
-        bs,
-        uhex1,
-        uhex2,
-        uhex3,
-        uhex4,
-        hex_done
-    };
-    escape_state       es{none};
-    unsigned int const factors[4]        = {12u, 8u, 4u, 0u};
-    int                codepoint         = 0;
-    auto*              factor            = factors;
-    auto               consume_codepoint = [&str, &factor, &es](int& cp, size_t i) -> bool {
-        if (detail::is_hex(str[i]))
+        sink(it, 2);
+        return it + 2;
+    }
+    if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+    {
+        if (available < 12 && !last && unicode_escape_prefix(it + 6, end)) return it;
+        uint32_t const low = available < 12 || it[6] != '\\' || it[7] != 'u' ? ~0u : hex4(it + 8);
+        if (low >= 0xDC00 && low <= 0xDFFF)
         {
-            cp += static_cast<int>(detail::from_hex(str[i]) << *factor++);
-            es = static_cast<decltype(es)>(static_cast<int>(es) + 1);
-            return true;
+            write_utf8(0x10000u + ((codepoint - 0xD800u) << 10u) + (low - 0xDC00u), sink);
+            return it + 12;
         }
-        else
+    }
+    // unpaired surrogates are kept as they are
+    if (codepoint >= 0xD800 && codepoint <= 0xDFFF)
+        sink(it, 6);
+    else
+        write_utf8(codepoint, sink);
+    return it + 6;
+}
+
+/**
+ * Decodes the escape sequence at it, which points to a backslash, and returns the position behind it. When the sequence
+ * may continue behind end and last is false nothing is decoded and it is returned. Malformed sequences are passed through.
+ */
+template <typename Sink>
+char const* decode_escape(char const* it, char const* end, bool last, Sink& sink)
+{
+    if (end - it < 2)
+    {
+        if (!last) return it;
+        sink(it, 1);
+        return end;
+    }
+    char c;
+    switch (it[1])
+    {
+        case '"': c = '"'; break;
+        case '\\': c = '\\'; break;
+        case '/': c = '/'; break;
+        case 'b': c = '\b'; break;
+        case 'f': c = '\f'; break;
+        case 'n': c = '\n'; break;
+        case 'r': c = '\r'; break;
+        case 't': c = '\t'; break;
+        case 'u': return decode_unicode_escape(it, end, last, sink);
+        default: sink(it, 2); return it + 2;
+    }
+    sink(&c, 1);
+    return it + 2;
+}
+
+/// passes the decoded text of [it, end) to sink(char const*, size_t) and returns the start of an escape sequence that
+/// continues behind end, or end. With last set incomplete sequences at the end are passed through.
+template <typename Sink>
+char const* unescape(char const* it, char const* end, bool last, Sink&& sink)
+{
+    while (it != end)
+    {
+        auto const escape = find_escape(it, end);
+        if (escape == end)
         {
-            return false;
+            sink(it, static_cast<size_t>(end - it));
+            return end;
         }
-    };
-    for (size_t i = 0; i != str.size(); ++i)
+        if (escape != it) sink(it, static_cast<size_t>(escape - it));
+        it = decode_escape(escape, end, last, sink);
+        if (it == escape) break;
+    }
+    return it;
+}
+}  // namespace detail
+/**
+ * Decodes a JSON string that arrives in fragments, like the string_value_start and string_value_cont events of the parser,
+ * without buffering it. Decoded text is passed to sink(char const*, size_t) as soon as it is complete. An escape sequence
+ * cut by the end of a fragment, including a \u sequence or a surrogate pair, is held back until the next fragment
+ * completes it. finish() ends the string and prepares for the next one.
+ */
+template <typename Sink>
+class json_unescaper
+{
+    Sink   output;
+    char   pending[12];  // start of an escape sequence, at most a surrogate pair that lacks its last digit
+    size_t pending_size{0};
+
+   public:
+    json_unescaper() = default;
+    explicit json_unescaper(Sink sink) : output(std::move(sink)) {}
+
+    void feed(std::string_view fragment)
     {
-        switch (es)
+        auto const sink = [this](char const* data, size_t size) { output(data, size); };
+        while (pending_size)
         {
-            case none:
-                if (str[i] == '\\') es = bs;
-                break;
-            case bs:
+            if (fragment.empty()) return;
+            auto const held  = pending_size;
+            auto const take  = std::min(sizeof pending - held, fragment.size());
+            std::memcpy(pending + held, fragment.data(), take);
+            auto const total = held + take;
+            auto const used  = static_cast<size_t>(detail::unescape(pending, pending + total, false, sink) - pending);
+            if (take == fragment.size())
+            {
+                std::memmove(pending, pending + used, total - used);
+                pending_size = total - used;
+                return;
+            }
+            if (used >= held)
+            {
+                fragment.remove_prefix(used - held);
+                pending_size = 0;
+            }
+            else
             {
-                char const* rep = nullptr;
-                switch (str[i])
-                {
-                    case '\\': rep = "\\"; break;
-                    case 'b': rep = "\b"; break;
-                    case 't': rep = "\t"; break;
-                    case 'r': rep = "\r"; break;
-                    case 'n': rep = "\n"; break;
-                    case '"': rep = "\""; break;
-                    case 'u':
-                        if (str.size() - i < 4) return str;  // with error
-                        es        = uhex1;
-                        factor    = factors;
-                        codepoint = 0;
-                        continue;
-                    default: return str;  // with error;
-                }
-                if (rep)
-                {
-                    str.replace(--i, 2, rep);
-                    --i;
-                    es = none;
-                }
-                break;
+                // a new sequence started within the held bytes, retry it with the fragment bytes it needs
+                std::memmove(pending, pending + used, held - used);
+                pending_size = held - used;
             }
-            case uhex1:
-            case uhex2:
-            case uhex3:
-            case uhex4:
-                if (!consume_codepoint(codepoint, i)) return str;  // error
-                if (es == hex_done)
-                {
-                    size_t chars_to_replace = 6;
-                    // two consecutive codepoints:
-                    if (0xD800 <= codepoint && codepoint <= 0xDBFF)
-                    {
-                        chars_to_replace += 6;
-                        int cp2 = 0;
-                        es      = uhex1;
-                        factor  = factors;
-                        if (i + 6 < str.size() && str[i + 1] == '\\' && str[i + 2] == 'u' && consume_codepoint(cp2, i + 3) &&
-                            consume_codepoint(cp2, i + 4) && consume_codepoint(cp2, i + 5) && consume_codepoint(cp2, i + 6))
-                        {
-                            if (0xDC00 <= cp2 && cp2 <= 0xDFFF)
-                                // overwrite codepoint
-                                codepoint = static_cast<int>(
-                                    // high surrogate occupies the most significant 22 bits
-                                    (static_cast<unsigned int>(codepoint) << 10u)
-                                    // low surrogate occupies the least significant 15 bits
-                                    + static_cast<unsigned int>(cp2)
-                                    // there is still the 0xD800, 0xDC00 and 0x10000 noise
-                                    // in the result so we have to subtract with:
-                                    // (0xD800 << 10) + DC00 - 0x10000 = 0x35FDC00
-                                    - 0x35FDC00u);
-                            else
-                                return str;  // error
-                        }
-                        else
-                        {
-                            return str;  // error
-                        }
-                    }
-                    else if (0xDC00 <= codepoint && codepoint <= 0xDFFF)
-                        return str;  // error
-                    char array[5]        = {0, 0, 0, 0, 0};
-                    auto replacement_pos = i - 5;
-                    if (codepoint < 0x80)
-                    {
-                        array[0] = static_cast<char>(codepoint);
-                        str.replace(replacement_pos, chars_to_replace, array);
-                        i -= 6;
-                    }
-                    else if (codepoint <= 0x7FF)
-                    {
-                        array[0] = static_cast<char>(0xC0u | (static_cast<unsigned int>(codepoint) >> 6u));
-                        array[1] = static_cast<char>(0x80u | (static_cast<unsigned int>(codepoint) & 0x3Fu));
-                        str.replace(replacement_pos, chars_to_replace, array);
-                        i -= 5;
-                    }
-                    else if (codepoint <= 0xFFFF)
-                    {
-                        // 3-byte characters: 1110xxxx 10xxxxxx 10xxxxxx
-                        array[0] = static_cast<char>(0xE0u | (static_cast<unsigned int>(codepoint) >> 12u));
-                        array[1] = static_cast<char>(0x80u | ((static_cast<unsigned int>(codepoint) >> 6u) & 0x3Fu));
-                        array[2] = static_cast<char>(0x80u | (static_cast<unsigned int>(codepoint) & 0x3Fu));
-                        str.replace(replacement_pos, chars_to_replace, array);
-                        i -= 4;
-                    }
-                    else
-                    {
-                        // 4-byte characters: 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-                        array[0] = static_cast<char>(0xF0u | (static_cast<unsigned int>(codepoint) >> 18u));
-                        array[1] = static_cast<char>(0x80u | ((static_cast<unsigned int>(codepoint) >> 12u) & 0x3Fu));
-                        array[2] = static_cast<char>(0x80u | ((static_cast<unsigned int>(codepoint) >> 6u) & 0x3Fu));
-                        array[3] = static_cast<char>(0x80u | (static_cast<unsigned int>(codepoint) & 0x3Fu));
-                        str.replace(replacement_pos, chars_to_replace, array);
-                        i -= 3;
-                    }
-                    es        = none;
-                }
-                break;
-            default: break;
         }
+        char const* const end  = fragment.data() + fragment.size();
+        char const* const rest = detail::unescape(fragment.data(), end, false, sink);
+        pending_size           = static_cast<size_t>(end - rest);
+        std::memcpy(pending, rest, pending_size);
+    }
+
+    /// passes an incomplete escape sequence at the end of the string through as it is
+    void finish()
+    {
+        detail::unescape(pending, pending + pending_size, true, [this](char const* data, size_t size) { output(data, size); });
+        pending_size = 0;
     }
+
+    /// drops an incomplete escape sequence
+    void reset() noexcept { pending_size = 0; }
+
+    Sink&       sink() noexcept { return output; }
+    Sink const& sink() const noexcept { return output; }
+};
+
+template <typename Sink>
+json_unescaper<std::decay_t<Sink>> make_json_unescaper(Sink&& sink)
+{
+    return json_unescaper<std::decay_t<Sink>>(std::forward<Sink>(sink));
+}
+
+/// Decodes the escape sequences of the text of a JSON string in place, in one pass that moves every byte at most once.
+/// Malformed sequences and unpaired surrogates are kept as they are.
+inline std::string& json_to_utf8(std::string& str)
+{
+    char const* const end   = str.data() + str.size();
+    char const* const first = detail::find_escape(str.data(), end);
+    if (first == end) return str;
+    // decoded text is never longer than its escaped form, so the output never overtakes the input
+    char* out = &str[static_cast<size_t>(first - str.data())];
+    detail::unescape(first, end, true, [&out](char const* data, size_t size) {
+        std::memmove(out, data, size);
+        out += size;
+    });
+    str.resize(static_cast<size_t>(out - str.data()));
     return str;
 }
 
+/// appends the decoded text of a JSON string to out
+inline std::string& json_to_utf8(std::string_view const& text, std::string& out)
+{
+    detail::unescape(text.data(), text.data() + text.size(), true, [&out](char const* data, size_t size) { out.append(data, size); });
+    return out;
+}
+
 inline std::string json_to_utf8(std::string const& str)
 {
-    std::string ret{str};
-    json_to_utf8(ret);
+    std::string ret;
+    ret.reserve(str.size());
+    json_to_utf8(std::string_view(str), ret);
     return ret;
 }
 inline std::string json_to_utf8(std::string&& str)
@@ -0,0 +1,326 @@
+/* ==========================================================================
+ Copyright (c) 2019 Andreas Pokorny
+ Distributed under the Boost Software License, Version 1.0. (See accompanying
+ file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+========================================================================== */
+
+#ifndef ASYNC_JSON_STRUCT_BINDER_HPP_INCLUDED
+#define ASYNC_JSON_STRUCT_BINDER_HPP_INCLUDED
+
+#include <async_json/json_extractor.hpp>
+#include <async_json/value_handler.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace async_json
+{
+/// Specialize with a static constexpr member value = fields(field("name", &T::member), ...) to let value_handler, bind and
+/// make_struct_parser fill a T from the members of an object. Members whose type has json_fields are bound the same way.
+template <typename T>
+struct json_fields;
+
+namespace detail
+{
+template <typename C, typename M>
+struct field_descriptor
+{
+    using member_type = M;
+    std::string_view name;
+    M C::*           member;
+    size_t           capacity;  // hint for the value_handler of the member
+};
+
+template <typename... Fs>
+struct field_list
+{
+    std::tuple<Fs...> items;
+};
+
+template <typename T, typename = void>
+struct has_json_fields : std::false_type
+{
+};
+
+template <typename T>
+struct has_json_fields<T, std::void_t<decltype(json_fields<T>::value)>> : std::true_type
+{
+};
+
+/// fnv1a hashes of the field names in ascending order with the field each one belongs to
+template <size_t N>
+struct field_table
+{
+    std::array<uint64_t, N>         hashes{};
+    std::array<uint32_t, N>         fields{};
+    std::array<std::string_view, N> names{};  // by field
+};
+
+template <typename... Fs, size_t... Is>
+constexpr auto make_field_table(field_list<Fs...> const& list, std::index_sequence<Is...>)
+{
+    field_table<sizeof...(Fs)> table{{{fnv1a(std::get<Is>(list.items).name)...}},
+                                     {{static_cast<uint32_t>(Is)...}},
+                                     {{std::get<Is>(list.items).name...}}};
+    for (size_t i = 1; i < sizeof...(Fs); ++i)
+        for (size_t j = i; j != 0 && table.hashes[j - 1] > table.hashes[j]; --j)
+        {
+            auto const h        = table.hashes[j];
+            auto const f        = table.fields[j];
+            table.hashes[j]     = table.hashes[j - 1];
+            table.fields[j]     = table.fields[j - 1];
+            table.hashes[j - 1] = h;
+            table.fields[j - 1] = f;
+        }
+    return table;
+}
+
+template <typename Traits, typename EH, typename Fields>
+struct field_handlers;
+
+template <typename Traits, typename EH, typename... Fs>
+struct field_handlers<Traits, EH, field_list<Fs...>>
+{
+    using type = std::tuple<value_handler<Traits, typename Fs::member_type, EH>...>;
+};
+
+/**
+ * Fills a T that has json_fields from an object. Member names are hashed while they arrive and looked up in a table sorted
+ * at compile time, the events of the member value go to the value_handler of that field. Members without a field are
+ * skipped. Values other than objects and null call error_handler().
+ */
+template <typename Traits, typename T, typename EH>
+struct value_handler<Traits, T, EH, std::enable_if_t<has_json_fields<T>::value>> : default_handler<Traits>
+{
+    using integer_t = typename Traits::integer_t;
+    using sv_t      = typename Traits::sv_t;
+    using float_t   = typename Traits::float_t;
+
+   private:
+    using list_t                          = std::decay_t<decltype(json_fields<T>::value)>;
+    using handlers_t                      = typename field_handlers<Traits, EH, list_t>::type;
+    static constexpr size_t   field_count = std::tuple_size<handlers_t>::value;
+    static constexpr uint32_t no_field    = ~0u;
+    static constexpr auto     table       = make_field_table(json_fields<T>::value, std::make_index_sequence<field_count>{});
+
+    handlers_t  fields;
+    EH          error_handler;
+    std::string name_buffer;
+    uint64_t    name_hash{fnv1a_offset};
+    uint32_t    current{no_field};
+    uint32_t    depth{0};  // 1 inside the object of T, more inside the value of a member
+
+    template <size_t... Is>
+    static handlers_t make_handlers(T& dest, EH& eh, std::index_sequence<Is...>)
+    {
+        return handlers_t{std::tuple_element_t<Is, handlers_t>(dest.*std::get<Is>(json_fields<T>::value.items).member, EH(eh),
+                                                               std::get<Is>(json_fields<T>::value.items).capacity)...};
+    }
+
+    /// passes a callback to the handler of the current field through a table indexed by the field
+    template <typename F>
+    parse_verdict forward(F&& f)
+    {
+        return forward(f, std::make_index_sequence<field_count>{});
+    }
+    template <typename F, size_t... Is>
+    parse_verdict forward(F& f, std::index_sequence<Is...>)
+    {
+        using entry                   = parse_verdict (*)(handlers_t&, F&);
+        static constexpr entry jump[] = {&forward_to<Is, F>...};
+        return current < field_count ? jump[current](fields, f) : parse_verdict::proceed;
+    }
+    template <size_t I, typename F>
+    static parse_verdict forward_to(handlers_t& handlers, F& f)
+    {
+        return verdict_of(f, std::get<I>(handlers));
+    }
+
+    template <typename F>
+    void scalar(F&& f)
+    {
+        if (depth == 0)
+        {
+            error_handler();
+            return;
+        }
+        forward(f);
+        if (depth == 1) current = no_field;
+    }
+
+    template <typename F>
+    void container_end(F&& f)
+    {
+        if (--depth == 0) return;
+        forward(f);
+        if (depth == 1) current = no_field;
+    }
+
+    parse_verdict select_field(sv_t const& member)
+    {
+        current          = no_field;
+        auto const begin = table.hashes.begin();
+        for (auto it = std::lower_bound(begin, table.hashes.end(), name_hash); it != table.hashes.end() && *it == name_hash; ++it)
+        {
+            auto const f = table.fields[it - begin];
+            if (table.names[f].size() == member.size() && equal_bytes(table.names[f].data(), member.data(), member.size()))
+            {
+                current = f;
+                return parse_verdict::proceed;
+            }
+        }
+        return parse_verdict::skip;
+    }
+
+   public:
+    value_handler(T& dest, EH&& eh, size_t /*capacity_hint*/ = 0)
+        : fields{make_handlers(dest, eh, std::make_index_sequence<field_count>{})}, error_handler{eh}
+    {
+    }
+
+    void value(bool v) { scalar([v](auto& h) { h.value(v); }); }
+    void value(integer_t v) { scalar([v](auto& h) { h.value(v); }); }
+    void value(float_t v) { scalar([v](auto& h) { h.value(v); }); }
+    void value(sv_t const& v) { scalar([&v](auto& h) { h.value(v); }); }
+    void number_value(sv_t const& v) { scalar([&v](auto& h) { h.number_value(v); }); }
+    /// null leaves fields other than std::optional as they are
+    void value(void*)
+    {
+        forward([](auto& h) { h.value(static_cast<void*>(nullptr)); });
+        if (depth == 1) current = no_field;
+    }
+    void string_value_start(sv_t const& v)
+    {
+        if (depth == 0)
+        {
+            error_handler();
+            return;
+        }
+        forward([&v](auto& h) { h.string_value_start(v); });
+    }
+    void string_value_cont(sv_t const& v) { forward([&v](auto& h) { h.string_value_cont(v); }); }
+    void string_value_end()
+    {
+        forward([](auto& h) { h.string_value_end(); });
+        if (depth == 1) current = no_field;
+    }
+
+    parse_verdict named_object(sv_t const& n)
+    {
+        if (depth != 1) return forward([&n](auto& h) { return h.named_object(n); });
+        name_hash = fnv1a(std::string_view(n.data(), n.size()));
+        return select_field(n);
+    }
+    parse_verdict named_object_start(sv_t const& n)
+    {
+        if (depth != 1) return forward([&n](auto& h) { return h.named_object_start(n); });
+        // a name that starts with this call continues in the next input buffer
+        name_buffer.assign(n.begin(), n.end());
+        name_hash = fnv1a(std::string_view(n.data(), n.size()));
+        return parse_verdict::proceed;
+    }
+    parse_verdict named_object_cont(sv_t const& n)
+    {
+        if (depth != 1) return forward([&n](auto& h) { return h.named_object_cont(n); });
+        name_buffer.append(n.begin(), n.end());
+        name_hash = fnv1a(std::string_view(n.data(), n.size()), name_hash);
+        return parse_verdict::proceed;
+    }
+    parse_verdict named_object_end()
+    {
+        if (depth != 1) return forward([](auto& h) { return h.named_object_end(); });
+        return select_field(sv_t(name_buffer.data(), name_buffer.size()));
+    }
+
+    parse_verdict object_start()
+    {
+        if (depth++ == 0)
+        {
+            current = no_field;
+            return parse_verdict::proceed;
+        }
+        return forward([](auto& h) { return h.object_start(); });
+    }
+    void          object_end() { container_end([](auto& h) { h.object_end(); }); }
+    parse_verdict array_start()
+    {
+        if (depth++ == 0)
+        {
+            error_handler();
+            return parse_verdict::skip;
+        }
+        return forward([](auto& h) { return h.array_start(); });
+    }
+    void array_end() { container_end([](auto& h) { h.array_end(); }); }
+};
+
+/// calls the parser callback of handler that corresponds to ev
+template <typename Handler, typename Traits>
+void dispatch_event(Handler& handler, saj_event_value<Traits> const& ev)
+{
+    switch (ev.event)
+    {
+        case saj_event::null_value: handler.value(static_cast<void*>(nullptr)); break;
+        case saj_event::integer_value: handler.value(ev.as_number()); break;
+        case saj_event::boolean_value: handler.value(ev.as_bool()); break;
+        case saj_event::float_value: handler.value(ev.as_float_number()); break;
+        case saj_event::number_value: handler.number_value(ev.as_string_view()); break;
+        case saj_event::object_start: handler.object_start(); break;
+        case saj_event::object_end: handler.object_end(); break;
+        case saj_event::array_start: handler.array_start(); break;
+        case saj_event::array_end: handler.array_end(); break;
+        case saj_event::object_name_start: handler.named_object_start(ev.as_string_view()); break;
+        case saj_event::object_name_cont: handler.named_object_cont(ev.as_string_view()); break;
+        case saj_event::object_name_end: handler.named_object_end(); break;
+        case saj_event::string_value_start: handler.string_value_start(ev.as_string_view()); break;
+        case saj_event::string_value_cont: handler.string_value_cont(ev.as_string_view()); break;
+        case saj_event::string_value_end: handler.string_value_end(); break;
+        case saj_event::parse_error: handler.error(ev.as_error_cause()); break;
+    }
+}
+}  // namespace detail
+
+/// binds the member pointed to by member to the object member called name, containers reserve capacity elements
+template <typename C, typename M>
+constexpr detail::field_descriptor<C, M> field(std::string_view name, M C::*member, size_t capacity = 0) noexcept
+{
+    return {name, member, capacity};
+}
+
+template <typename... Fs>
+constexpr detail::field_list<Fs...> fields(Fs... fs) noexcept
+{
+    static_assert(sizeof...(Fs) > 0, "a bound struct needs at least one field");
+    return {std::tuple<Fs...>{fs...}};
+}
+
+/// path action that fills dest from the selected value, on_mismatch() is called for values that do not fit their field
+template <typename Traits = default_traits, typename T, typename EH>
+auto bind(T& dest, EH&& on_mismatch)
+{
+    return [handler = detail::value_handler<Traits, T, std::decay_t<EH>>(dest, std::decay_t<EH>(std::forward<EH>(on_mismatch)))](
+               auto const& ev) mutable { detail::dispatch_event(handler, ev); };
+}
+
+template <typename Traits = default_traits, typename T>
+auto bind(T& dest)
+{
+    return bind<Traits>(dest, [] {});
+}
+
+/// parser that fills dest from a document that is one object, members without a field are skipped without being parsed
+template <typename Traits = default_traits, typename T, typename EH>
+auto make_struct_parser(T& dest, EH&& on_mismatch)
+{
+    using handler_t = detail::value_handler<Traits, T, std::decay_t<EH>>;
+    return basic_json_parser<handler_t, Traits>(handler_t(dest, std::decay_t<EH>(std::forward<EH>(on_mismatch))));
+}
+
+}  // namespace async_json
+
+#endif
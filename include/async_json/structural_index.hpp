@@ -0,0 +1,301 @@
+/* ==========================================================================
+ Copyright (c) 2019 Andreas Pokorny
+ Distributed under the Boost Software License, Version 1.0. (See accompanying
+ file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+========================================================================== */
+
+#ifndef ASYNC_JSON_STRUCTURAL_INDEX_HPP_INCLUDED
+#define ASYNC_JSON_STRUCTURAL_INDEX_HPP_INCLUDED
+
+#include <cstdint>
+#include <async_json/simd_scan.hpp>
+
+namespace async_json
+{
+namespace detail
+{
+/// character masks of a 64 byte block, bit i stands for byte i
+struct block_masks
+{
+    uint64_t quote{0};
+    uint64_t backslash{0};
+    uint64_t whitespace{0};
+    uint64_t structural{0};  ///< one of {}[]:,
+    uint64_t open{0};        ///< one of {[
+    uint64_t close{0};       ///< one of }]
+};
+
+inline block_masks classify_block(char const* block) noexcept
+{
+    block_masks m;
+#if defined(ASYNC_JSON_SSE2)
+    for (unsigned part = 0; part != 4; ++part)
+    {
+        __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 16 * part));
+        auto const    eq    = [&chunk](char c) { return _mm_cmpeq_epi8(chunk, _mm_set1_epi8(c)); };
+        auto const    bits  = [part](__m128i v) { return uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(v))} << (16 * part); };
+        __m128i const blank = _mm_or_si128(_mm_or_si128(eq(' '), eq('\t')), _mm_or_si128(eq('\n'), eq('\r')));
+        __m128i const open  = _mm_or_si128(eq('{'), eq('['));
+        __m128i const close = _mm_or_si128(eq('}'), eq(']'));
+        m.quote |= bits(eq('"'));
+        m.backslash |= bits(eq('\\'));
+        m.whitespace |= bits(_mm_or_si128(blank, eq('\b')));
+        m.open |= bits(open);
+        m.close |= bits(close);
+        m.structural |= bits(_mm_or_si128(_mm_or_si128(open, close), _mm_or_si128(eq(':'), eq(','))));
+    }
+#else
+    for (unsigned i = 0; i != 64; ++i)
+    {
+        uint64_t const bit = uint64_t{1} << i;
+        switch (block[i])
+        {
+            case '"': m.quote |= bit; break;
+            case '\\': m.backslash |= bit; break;
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+            case '\b': m.whitespace |= bit; break;
+            case '{':
+            case '[':
+                m.open |= bit;
+                m.structural |= bit;
+                break;
+            case '}':
+            case ']':
+                m.close |= bit;
+                m.structural |= bit;
+                break;
+            case ':':
+            case ',': m.structural |= bit; break;
+            default: break;
+        }
+    }
+#endif
+    return m;
+}
+
+/// bit i is set when an odd number of bits in [0, i] is set
+constexpr uint64_t prefix_xor(uint64_t x) noexcept
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+/// Returns the bytes escaped by a backslash and stores the escaping backslashes in escapes. Carry tells whether the first
+/// byte is escaped and receives whether the first byte of the next block is.
+inline uint64_t find_escaped(uint64_t backslash, bool& carry, uint64_t& escapes) noexcept
+{
+    uint64_t escaped = carry ? 1 : 0;
+    escapes          = 0;
+    carry            = false;
+    // backslashes are rare, resolve them one escape sequence at a time
+    for (uint64_t b = backslash & ~escaped; b;)
+    {
+        uint64_t const bit = b & (0 - b);
+        escapes |= bit;
+        escaped |= bit << 1;
+        carry = (bit >> 63) != 0;
+        b &= ~(bit | bit << 1);
+    }
+    return escaped;
+}
+
+/// Stage one of the structural index parser: selects the bytes of a 64 byte block that the parser state machine has to see.
+/// Those are all bytes outside of strings except whitespace that neither terminates a number nor a keyword, and inside of
+/// strings only quotes, backslashes and escaped characters. Everything else is either skipped whitespace or string content.
+struct structural_scanner
+{
+    bool in_string{false};     ///< the next block starts inside a string
+    bool escaped{false};       ///< the first byte of the next block is escaped by a backslash
+    bool after_scalar{false};  ///< the last byte of the previous block belongs to a number or keyword
+
+    uint64_t next(char const* block) noexcept
+    {
+        block_masks const m = classify_block(block);
+        uint64_t          escapes;
+        uint64_t const    escaped_bytes = find_escaped(m.backslash, escaped, escapes);
+        uint64_t const    quotes        = m.quote & ~escaped_bytes;
+        uint64_t const    string_mask   = prefix_xor(quotes) ^ (in_string ? ~uint64_t{0} : 0);  // opening quote up to closing quote
+        uint64_t const    outside       = ~string_mask;
+        uint64_t const    scalar        = outside & ~(m.whitespace | m.structural | quotes);
+        uint64_t const    terminating   = m.whitespace & outside & (scalar << 1 | (after_scalar ? 1 : 0));
+        in_string                       = (string_mask >> 63) != 0;
+        after_scalar                    = (scalar >> 63) != 0;
+        return quotes | (string_mask & (escapes | escaped_bytes)) | (outside & ~m.whitespace) | terminating;
+    }
+};
+
+/// Finds the end of a string, object or array without looking at its content, resumable across input buffers.
+/// The content is not validated beyond counting brackets outside of strings.
+struct skip_scanner
+{
+    uint32_t depth{0};        ///< unclosed brackets, zero when only the rest of a string is skipped
+    bool     in_string{false};
+    bool     escaped{false};
+
+    /// returns the quote or bracket that completes the value or end
+    char const* find_end(char const* it, char const* end) noexcept
+    {
+        for (; end - it >= 64; it += 64)
+        {
+            block_masks const m = classify_block(it);
+            uint64_t          escapes;
+            uint64_t const    quotes      = m.quote & ~find_escaped(m.backslash, escaped, escapes);
+            uint64_t const    string_mask = prefix_xor(quotes) ^ (in_string ? ~uint64_t{0} : 0);
+            uint64_t const    open        = m.open & ~string_mask;
+            uint64_t const    close       = m.close & ~string_mask;
+            if (depth == 0)
+            {
+                if (uint64_t const closing = quotes & ~string_mask) return it + count_trailing_zeros(closing);
+            }
+            else if (popcount(close) < depth)
+                depth = depth + popcount(open) - popcount(close);
+            else
+            {
+                for (uint64_t b = open | close; b; b &= b - 1)
+                {
+                    auto const pos = count_trailing_zeros(b);
+                    if (open & (uint64_t{1} << pos))
+                        ++depth;
+                    else if (--depth == 0)
+                        return it + pos;
+                }
+            }
+            in_string = (string_mask >> 63) != 0;
+        }
+        for (; it != end; ++it)
+        {
+            char const c = *it;
+            if (in_string)
+            {
+                if (escaped)
+                    escaped = false;
+                else if (c == '\\')
+                    escaped = true;
+                else if (c == '"')
+                {
+                    in_string = false;
+                    if (depth == 0) return it;
+                }
+            }
+            else if (c == '"')
+                in_string = true;
+            else if (c == '{' || c == '[')
+                ++depth;
+            else if ((c == '}' || c == ']') && --depth == 0)
+                return it;
+        }
+        return end;
+    }
+};
+
+/// Checks a number or keyword that is skipped without the parser state machine, resumable across input buffers. It
+/// follows the grammar of the state machine, which also takes leading zeros and fractions without digits.
+struct scalar_scanner
+{
+    enum class stage : uint8_t
+    {
+        start,
+        minus,  // a number needs a digit after the sign
+        integer,
+        fraction,
+        exponent_sign,
+        exponent,
+        keyword
+    };
+    stage       at{stage::start};
+    bool        invalid{false};
+    char const* rest{""};  ///< characters of the keyword that are still expected
+
+    /// returns the delimiter behind the value or end, sets invalid and stops at a character that does not fit the value
+    char const* find_end(char const* it, char const* end) noexcept
+    {
+        for (; it != end; ++it)
+        {
+            char const c = *it;
+            if (is_whitespace(c) || c == ',' || c == '}' || c == ']')
+            {
+                invalid = !complete();
+                return it;
+            }
+            if (!consume(c))
+            {
+                invalid = true;
+                return it;
+            }
+        }
+        return end;
+    }
+
+    /// true when a delimiter may follow the characters seen so far
+    bool complete() const noexcept
+    {
+        switch (at)
+        {
+            case stage::integer:
+            case stage::fraction:
+            case stage::exponent: return true;
+            case stage::keyword: return *rest == 0;
+            default: return false;
+        }
+    }
+
+   private:
+    bool consume(char c) noexcept
+    {
+        bool const digit = c >= '0' && c <= '9';
+        switch (at)
+        {
+            case stage::start:
+                if (c == '-')
+                    at = stage::minus;
+                else if (digit)
+                    at = stage::integer;
+                else if (c == 't' || c == 'f' || c == 'n')
+                {
+                    rest = c == 't' ? "rue" : c == 'f' ? "alse" : "ull";
+                    at   = stage::keyword;
+                }
+                else
+                    return false;
+                return true;
+            case stage::minus:
+                if (!digit) return false;
+                at = stage::integer;
+                return true;
+            case stage::integer:
+                if (c == '.')
+                    at = stage::fraction;
+                else if (c == 'e' || c == 'E')
+                    at = stage::exponent_sign;
+                else
+                    return digit;
+                return true;
+            case stage::fraction:
+                if (c != 'e' && c != 'E') return digit;
+                at = stage::exponent_sign;
+                return true;
+            case stage::exponent_sign:
+                if (!digit && c != '-' && c != '+') return false;
+                at = stage::exponent;
+                return true;
+            case stage::exponent: return digit;
+            case stage::keyword:
+                if (*rest != c) return false;
+                ++rest;
+                return true;
+        }
+        return false;
+    }
+};
+}  // namespace detail
+}  // namespace async_json
+
+#endif
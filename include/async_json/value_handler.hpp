@@ -0,0 +1,603 @@
+/* ==========================================================================
+ Copyright (c) 2019 Andreas Pokorny
+ Distributed under the Boost Software License, Version 1.0. (See accompanying
+ file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+========================================================================== */
+
+#ifndef ASYNC_JSON_VALUE_HANDLER_HPP_INCLUDED
+#define ASYNC_JSON_VALUE_HANDLER_HPP_INCLUDED
+
+#include <async_json/basic_json_parser.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace async_json
+{
+/**
+ * Customization point for the containers value_handler fills. Sequences that are filled from arrays provide
+ *   using value_type = ...;
+ *   static value_type& append(C&);                          default constructs a new last element
+ * containers that are filled from objects provide
+ *   using mapped_type = ...;
+ *   static mapped_type& insert(C&, std::string const& key); the element stored under key
+ * and both provide static void reserve(C&, size_t capacity), which is called with the capacity hint of the destination
+ * when the array or object starts. The reference returned by append needs to stay valid until the next append.
+ */
+template <typename C, typename = void>
+struct container_traits;
+
+template <typename T, typename A>
+struct container_traits<std::vector<T, A>>
+{
+    static_assert(!std::is_same_v<T, bool>,
+                  "std::vector<bool> has no bool& for the element handler to fill, use std::vector<char> or a container_traits "
+                  "specialization for the exact std::vector<bool, A> instead");
+    using value_type = T;
+    static void reserve(std::vector<T, A>& c, size_t capacity) { c.reserve(capacity); }
+    static T&   append(std::vector<T, A>& c) { return c.emplace_back(); }
+};
+
+template <typename T, typename C, typename A>
+struct container_traits<std::map<std::string, T, C, A>>
+{
+    using mapped_type = T;
+    static void reserve(std::map<std::string, T, C, A>&, size_t) {}
+    static T&   insert(std::map<std::string, T, C, A>& c, std::string const& key) { return c[key]; }
+};
+
+template <typename T, typename H, typename E, typename A>
+struct container_traits<std::unordered_map<std::string, T, H, E, A>>
+{
+    using mapped_type = T;
+    static void reserve(std::unordered_map<std::string, T, H, E, A>& c, size_t capacity) { c.reserve(capacity); }
+    static T&   insert(std::unordered_map<std::string, T, H, E, A>& c, std::string const& key) { return c[key]; }
+};
+
+namespace detail
+{
+template <typename C>
+struct is_std_array : std::false_type
+{
+};
+
+template <typename T, size_t N>
+struct is_std_array<std::array<T, N>> : std::true_type
+{
+};
+
+template <typename C, typename = void>
+struct is_sequence : std::false_type
+{
+};
+
+template <typename C>
+struct is_sequence<C, std::void_t<decltype(container_traits<C>::append(std::declval<C&>()))>> : std::true_type
+{
+};
+
+template <typename T, size_t N>
+struct is_sequence<std::array<T, N>> : std::true_type
+{
+};
+
+template <typename C>
+struct sequence_element
+{
+    using type = typename container_traits<C>::value_type;
+};
+
+template <typename T, size_t N>
+struct sequence_element<std::array<T, N>>
+{
+    using type = T;
+};
+
+template <typename C, typename = void>
+struct is_mapping : std::false_type
+{
+};
+
+template <typename C>
+struct is_mapping<C, std::void_t<decltype(container_traits<C>::insert(std::declval<C&>(), std::declval<std::string const&>()))>>
+    : std::true_type
+{
+};
+
+/// calls f(handler) and passes on the parse_verdict when the callback of the handler returns one
+template <typename F, typename H>
+parse_verdict verdict_of(F& f, H& handler)
+{
+    if constexpr (std::is_same_v<decltype(f(handler)), parse_verdict>)
+        return f(handler);
+    else
+    {
+        f(handler);
+        return parse_verdict::proceed;
+    }
+}
+
+/// Parser handler that stores the value it is given in a T and calls error_handler() on values that do not fit. Every
+/// specialization is constructed from the destination, the error handler and a capacity hint for the containers it fills.
+template <typename Traits, typename T, typename EH, typename = void>
+struct value_handler;
+
+/// Counts the nesting of an object or array that arrived in place of a scalar: the first start calls error_handler() and
+/// asks the parser to skip, the events up to the matching end are ignored.
+struct scalar_rejection
+{
+    uint32_t rejected{0};  // depth inside an object or array in place of the value
+
+    template <typename EH>
+    parse_verdict container_start(EH& error_handler)
+    {
+        if (rejected++ != 0) return parse_verdict::proceed;
+        error_handler();
+        return parse_verdict::skip;
+    }
+    void container_end()
+    {
+        if (rejected) --rejected;
+    }
+};
+
+template <typename Traits, typename T, typename EH, typename>
+struct value_handler : default_handler<Traits>
+{
+    using integer_t = typename Traits::integer_t;
+    using sv_t      = typename Traits::sv_t;
+    using float_t   = typename Traits::float_t;
+    T&               destination;
+    EH               error_handler;
+    scalar_rejection nested;
+    value_handler(T& dest, EH&& eh, size_t /*capacity_hint*/ = 0) : destination{dest}, error_handler{eh} {}
+    template <typename VT>
+    void value(VT const& vt, typename std::enable_if<std::is_convertible<VT, T>::value>::type* /*ptr*/ = nullptr)
+    {
+        if (!nested.rejected) destination = vt;
+    }
+    template <typename VT>
+    void value(VT const&, typename std::enable_if<!std::is_convertible<VT, T>::value>::type* /*ptr*/ = nullptr)
+    {
+        if (!nested.rejected) error_handler();
+    }
+    /// null leaves the destination as it is
+    void value(void*) {}
+    void string_value_start(sv_t const&)
+    {
+        if (!nested.rejected) error_handler();
+    }
+    void string_value_cont(sv_t const&)
+    {
+        if (!nested.rejected) error_handler();
+    }
+    void string_value_end()
+    {
+        if (!nested.rejected) error_handler();
+    }
+    parse_verdict object_start() { return nested.container_start(error_handler); }
+    void          object_end() { nested.container_end(); }
+    parse_verdict array_start() { return nested.container_start(error_handler); }
+    void          array_end() { nested.container_end(); }
+};
+
+template <typename Traits, typename EH>
+struct value_handler<Traits, std::string, EH> : default_handler<Traits>
+{
+    using integer_t = typename Traits::integer_t;
+    using sv_t      = typename Traits::sv_t;
+    using float_t   = typename Traits::float_t;
+    std::string&     destination;
+    EH               error_handler;
+    size_t           capacity;
+    scalar_rejection nested;
+    value_handler(std::string& dest, EH&& eh, size_t capacity_hint = 0) : destination{dest}, error_handler{eh}, capacity{capacity_hint} {}
+    using default_handler<Traits>::value;
+    void value(sv_t const& str)
+    {
+        if (!nested.rejected) destination.assign(str.begin(), str.end());
+    }
+    void string_value_start(sv_t const& s)
+    {
+        if (nested.rejected) return;
+        destination.reserve(capacity);
+        destination.assign(s.begin(), s.end());
+    }
+    void string_value_cont(sv_t const& s)
+    {
+        if (!nested.rejected) destination.append(s.begin(), s.end());
+    }
+    void string_value_end() {}
+    parse_verdict object_start() { return nested.container_start(error_handler); }
+    void          object_end() { nested.container_end(); }
+    parse_verdict array_start() { return nested.container_start(error_handler); }
+    void          array_end() { nested.container_end(); }
+};
+
+/**
+ * Fills the sequence C from an array, a std::array or a container with container_traits. Every element gets a
+ * value_handler of its own, so elements can be containers or bound structs themselves. The capacity hint is reserved
+ * when the array starts, elements beyond the size of a std::array call error_handler(). So does any value in place of the
+ * array, including a string for a std::vector<std::string>.
+ */
+template <typename Traits, typename C, typename EH>
+struct value_handler<Traits, C, EH, std::enable_if_t<is_sequence<C>::value>> : default_handler<Traits>
+{
+    using integer_t = typename Traits::integer_t;
+    using sv_t      = typename Traits::sv_t;
+    using float_t   = typename Traits::float_t;
+
+   private:
+    using element_t = value_handler<Traits, typename sequence_element<C>::type, EH>;
+
+    C&                       destination;
+    EH                       error_handler;
+    size_t                   capacity;
+    std::optional<element_t> element;
+    size_t                   count{0};     // elements of the current array
+    uint32_t                 depth{0};     // 1 inside the array, more inside an element
+    uint32_t                 rejected{0};  // depth inside an object in place of the array
+
+    void begin_element()
+    {
+        element.reset();
+        if constexpr (is_std_array<C>::value)
+        {
+            if (count == destination.size())
+            {
+                error_handler();
+                return;
+            }
+            element.emplace(destination[count++], EH(error_handler));
+        }
+        else
+            element.emplace(container_traits<C>::append(destination), EH(error_handler));
+    }
+
+    template <typename F>
+    parse_verdict forward(F&& f)
+    {
+        return element ? verdict_of(f, *element) : parse_verdict::proceed;
+    }
+
+    /// a value that ends with this callback or that starts a string
+    template <typename F>
+    void scalar(F&& f)
+    {
+        if (rejected) return;
+        if (depth == 0)
+        {
+            error_handler();
+            return;
+        }
+        if (depth == 1) begin_element();
+        forward(f);
+    }
+
+    template <typename F>
+    parse_verdict container_start(F&& f)
+    {
+        if (rejected)
+        {
+            ++rejected;
+            return parse_verdict::proceed;
+        }
+        if (depth++ == 1) begin_element();
+        return forward(f);
+    }
+
+    template <typename F>
+    void container_end(F&& f)
+    {
+        if (rejected)
+        {
+            --rejected;
+            return;
+        }
+        if (--depth != 0) forward(f);
+    }
+
+   public:
+    value_handler(C& dest, EH&& eh, size_t capacity_hint = 0) : destination{dest}, error_handler{eh}, capacity{capacity_hint} {}
+
+    void value(bool v) { scalar([v](auto& h) { h.value(v); }); }
+    void value(integer_t v) { scalar([v](auto& h) { h.value(v); }); }
+    void value(float_t v) { scalar([v](auto& h) { h.value(v); }); }
+    void value(sv_t const& v) { scalar([&v](auto& h) { h.value(v); }); }
+    void number_value(sv_t const& v) { scalar([&v](auto& h) { h.number_value(v); }); }
+    void value(void*)
+    {
+        if (rejected || depth == 0) return;
+        if (depth == 1) begin_element();
+        forward([](auto& h) { h.value(static_cast<void*>(nullptr)); });
+    }
+    void string_value_start(sv_t const& v) { scalar([&v](auto& h) { h.string_value_start(v); }); }
+    void string_value_cont(sv_t const& v)
+    {
+        if (!rejected) forward([&v](auto& h) { h.string_value_cont(v); });
+    }
+    void string_value_end()
+    {
+        if (!rejected) forward([](auto& h) { h.string_value_end(); });
+    }
+
+    parse_verdict named_object(sv_t const& n)
+    {
+        return rejected ? parse_verdict::proceed : forward([&n](auto& h) { return h.named_object(n); });
+    }
+    parse_verdict named_object_start(sv_t const& n)
+    {
+        return rejected ? parse_verdict::proceed : forward([&n](auto& h) { return h.named_object_start(n); });
+    }
+    parse_verdict named_object_cont(sv_t const& n)
+    {
+        return rejected ? parse_verdict::proceed : forward([&n](auto& h) { return h.named_object_cont(n); });
+    }
+    parse_verdict named_object_end() { return rejected ? parse_verdict::proceed : forward([](auto& h) { return h.named_object_end(); }); }
+
+    parse_verdict object_start()
+    {
+        if (depth == 0 && !rejected)
+        {
+            error_handler();
+            rejected = 1;
+            return parse_verdict::skip;
+        }
+        return container_start([](auto& h) { return h.object_start(); });
+    }
+    void          object_end() { container_end([](auto& h) { h.object_end(); }); }
+    parse_verdict array_start()
+    {
+        if (depth == 0 && !rejected)
+        {
+            depth = 1;
+            count = 0;
+            element.reset();
+            if constexpr (!is_std_array<C>::value) container_traits<C>::reserve(destination, capacity);
+            return parse_verdict::proceed;
+        }
+        return container_start([](auto& h) { return h.array_start(); });
+    }
+    void array_end() { container_end([](auto& h) { h.array_end(); }); }
+};
+
+/// Fills C with container_traits, for example std::map or std::unordered_map with std::string keys, from the members of an
+/// object. Each member value is filled by a value_handler of the mapped type. The capacity hint is reserved when the object
+/// starts.
+template <typename Traits, typename C, typename EH>
+struct value_handler<Traits, C, EH, std::enable_if_t<is_mapping<C>::value>> : default_handler<Traits>
+{
+    using integer_t = typename Traits::integer_t;
+    using sv_t      = typename Traits::sv_t;
+    using float_t   = typename Traits::float_t;
+
+   private:
+    using element_t = value_handler<Traits, typename container_traits<C>::mapped_type, EH>;
+
+    C&                       destination;
+    EH                       error_handler;
+    size_t                   capacity;
+    std::optional<element_t> element;
+    std::string              key;
+    uint32_t                 depth{0};     // 1 inside the object, more inside a member value
+    uint32_t                 rejected{0};  // depth inside an array in place of the object
+
+    void begin_member() { element.emplace(container_traits<C>::insert(destination, key), EH(error_handler)); }
+
+    template <typename F>
+    parse_verdict forward(F&& f)
+    {
+        return element && depth != 0 ? verdict_of(f, *element) : parse_verdict::proceed;
+    }
+
+    template <typename F>
+    void scalar(F&& f)
+    {
+        if (rejected) return;
+        if (depth == 0)
+        {
+            error_handler();
+            return;
+        }
+        forward(f);
+    }
+
+    template <typename F>
+    parse_verdict container_start(F&& f)
+    {
+        if (rejected)
+        {
+            ++rejected;
+            return parse_verdict::proceed;
+        }
+        ++depth;
+        return forward(f);
+    }
+
+    template <typename F>
+    void container_end(F&& f)
+    {
+        if (rejected)
+        {
+            --rejected;
+            return;
+        }
+        if (--depth != 0) forward(f);
+    }
+
+   public:
+    value_handler(C& dest, EH&& eh, size_t capacity_hint = 0) : destination{dest}, error_handler{eh}, capacity{capacity_hint} {}
+
+    void value(bool v) { scalar([v](auto& h) { h.value(v); }); }
+    void value(integer_t v) { scalar([v](auto& h) { h.value(v); }); }
+    void value(float_t v) { scalar([v](auto& h) { h.value(v); }); }
+    void value(sv_t const& v) { scalar([&v](auto& h) { h.value(v); }); }
+    void number_value(sv_t const& v) { scalar([&v](auto& h) { h.number_value(v); }); }
+    void value(void*)
+    {
+        if (!rejected) forward([](auto& h) { h.value(static_cast<void*>(nullptr)); });
+    }
+    void string_value_start(sv_t const& v) { scalar([&v](auto& h) { h.string_value_start(v); }); }
+    void string_value_cont(sv_t const& v)
+    {
+        if (!rejected) forward([&v](auto& h) { h.string_value_cont(v); });
+    }
+    void string_value_end()
+    {
+        if (!rejected) forward([](auto& h) { h.string_value_end(); });
+    }
+
+    parse_verdict named_object(sv_t const& n)
+    {
+        if (rejected) return parse_verdict::proceed;
+        if (depth != 1) return forward([&n](auto& h) { return h.named_object(n); });
+        key.assign(n.begin(), n.end());
+        begin_member();
+        return parse_verdict::proceed;
+    }
+    parse_verdict named_object_start(sv_t const& n)
+    {
+        if (rejected) return parse_verdict::proceed;
+        if (depth != 1) return forward([&n](auto& h) { return h.named_object_start(n); });
+        key.assign(n.begin(), n.end());
+        return parse_verdict::proceed;
+    }
+    parse_verdict named_object_cont(sv_t const& n)
+    {
+        if (rejected) return parse_verdict::proceed;
+        if (depth != 1) return forward([&n](auto& h) { return h.named_object_cont(n); });
+        key.append(n.begin(), n.end());
+        return parse_verdict::proceed;
+    }
+    parse_verdict named_object_end()
+    {
+        if (rejected) return parse_verdict::proceed;
+        if (depth != 1) return forward([](auto& h) { return h.named_object_end(); });
+        begin_member();
+        return parse_verdict::proceed;
+    }
+
+    parse_verdict object_start()
+    {
+        if (depth == 0 && !rejected)
+        {
+            depth = 1;
+            element.reset();
+            container_traits<C>::reserve(destination, capacity);
+            return parse_verdict::proceed;
+        }
+        return container_start([](auto& h) { return h.object_start(); });
+    }
+    void          object_end() { container_end([](auto& h) { h.object_end(); }); }
+    parse_verdict array_start()
+    {
+        if (depth == 0 && !rejected)
+        {
+            error_handler();
+            rejected = 1;
+            return parse_verdict::skip;
+        }
+        return container_start([](auto& h) { return h.array_start(); });
+    }
+    void array_end() { container_end([](auto& h) { h.array_end(); }); }
+};
+
+/// null resets the optional, any other value constructs a T that the value_handler of T fills
+template <typename Traits, typename T, typename EH>
+struct value_handler<Traits, std::optional<T>, EH> : default_handler<Traits>
+{
+    using integer_t = typename Traits::integer_t;
+    using sv_t      = typename Traits::sv_t;
+    using float_t   = typename Traits::float_t;
+
+   private:
+    using inner_t = value_handler<Traits, T, EH>;
+
+    std::optional<T>&      destination;
+    EH                     error_handler;
+    size_t                 capacity;
+    std::optional<inner_t> inner;
+    uint32_t               depth{0};
+
+    /// f is the first callback of a value when depth is 0
+    template <typename F>
+    parse_verdict begin(F&& f)
+    {
+        if (depth == 0)
+        {
+            inner.reset();
+            destination.emplace();
+            inner.emplace(*destination, EH(error_handler), capacity);
+        }
+        return forward(f);
+    }
+
+    template <typename F>
+    parse_verdict forward(F&& f)
+    {
+        return inner ? verdict_of(f, *inner) : parse_verdict::proceed;
+    }
+
+   public:
+    value_handler(std::optional<T>& dest, EH&& eh, size_t capacity_hint = 0)
+        : destination{dest}, error_handler{eh}, capacity{capacity_hint}
+    {
+    }
+
+    void value(bool v) { begin([v](auto& h) { h.value(v); }); }
+    void value(integer_t v) { begin([v](auto& h) { h.value(v); }); }
+    void value(float_t v) { begin([v](auto& h) { h.value(v); }); }
+    void value(sv_t const& v) { begin([&v](auto& h) { h.value(v); }); }
+    void number_value(sv_t const& v) { begin([&v](auto& h) { h.number_value(v); }); }
+    void value(void*)
+    {
+        if (depth != 0) forward([](auto& h) { h.value(static_cast<void*>(nullptr)); });
+        else
+        {
+            inner.reset();
+            destination.reset();
+        }
+    }
+    void string_value_start(sv_t const& v) { begin([&v](auto& h) { h.string_value_start(v); }); }
+    void string_value_cont(sv_t const& v) { forward([&v](auto& h) { h.string_value_cont(v); }); }
+    void string_value_end() { forward([](auto& h) { h.string_value_end(); }); }
+
+    parse_verdict named_object(sv_t const& n) { return forward([&n](auto& h) { return h.named_object(n); }); }
+    parse_verdict named_object_start(sv_t const& n) { return forward([&n](auto& h) { return h.named_object_start(n); }); }
+    parse_verdict named_object_cont(sv_t const& n) { return forward([&n](auto& h) { return h.named_object_cont(n); }); }
+    parse_verdict named_object_end() { return forward([](auto& h) { return h.named_object_end(); }); }
+
+    parse_verdict object_start()
+    {
+        auto const verdict = begin([](auto& h) { return h.object_start(); });
+        ++depth;
+        return verdict;
+    }
+    void object_end()
+    {
+        --depth;
+        forward([](auto& h) { h.object_end(); });
+    }
+    parse_verdict array_start()
+    {
+        auto const verdict = begin([](auto& h) { return h.array_start(); });
+        ++depth;
+        return verdict;
+    }
+    void array_end()
+    {
+        --depth;
+        forward([](auto& h) { h.array_end(); });
+    }
+};
+}  // namespace detail
+}  // namespace async_json
+
+#endif
@@ -99,3 +99,421 @@ TEST_CASE("JSON Path: arbitrary")
     extractor.parse_bytes(std::string_view(val, sizeof(val)));
     REQUIRE(foo == 31);
 }
+
+TEST_CASE("JSON Path: shared prefixes")
+{
+    constexpr char val[] = R"({"a":{"b":1,"c":{"d":2,"e":"x"}},"f":[{"a":{"b":3}}],"g":4} )";
+    long           b = 0, d = 0, g = 0, sum = 0;
+    std::string    e;
+    auto           extractor = a::make_extractor([](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; },
+                                       a::path(a::assign_numeric(b), "a", "b"), a::path(a::assign_numeric(d), "a", "c", "d"),
+                                       a::path(a::assign_string(e), "a", "c", "e"), a::path(a::assign_numeric(g), "g"),
+                                       a::path([&sum](auto const& ev) { sum += ev.as_number(); }, "f", "a", "b"));
+    extractor.parse_bytes(std::string_view(val, sizeof(val)));
+    REQUIRE(b == 1);
+    REQUIRE(d == 2);
+    REQUIRE(e == "x");
+    REQUIRE(g == 4);
+    REQUIRE(sum == 3);
+}
+
+TEST_CASE("JSON Path: nested and overlapping paths")
+{
+    constexpr char           val[] = R"({"a":{"b":{"c":5},"z":6}} )";
+    std::vector<a::saj_event> outer;
+    long                     c = 0, any_child = 0;
+    auto extractor = a::make_extractor([](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; },
+                                       a::path([&outer](auto const& ev) { outer.push_back(ev.event); }, "a", "b"),
+                                       a::path(a::assign_numeric(c), "a", "b", "c"),
+                                       a::path([&any_child](auto const& ev) { any_child += ev.event == a::saj_event::integer_value; }, "a",
+                                               a::arbitrary));
+    extractor.parse_bytes(std::string_view(val, sizeof(val)));
+    REQUIRE(c == 5);
+    REQUIRE(any_child == 2);
+    REQUIRE(outer == std::vector<a::saj_event>{a::saj_event::object_start, a::saj_event::object_name_start, a::saj_event::object_name_end,
+                                               a::saj_event::integer_value, a::saj_event::object_end});
+}
+
+TEST_CASE("JSON Path: member names split across input buffers")
+{
+    std::string_view const doc = R"({"long_member_name":{"other":1,"inner":17}} )";
+    long                   inner = 0;
+    auto extractor = a::make_extractor([](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; },
+                                       a::path(a::assign_numeric(inner), "long_member_name", "inner"));
+    char buffer[1];  // reused for every byte, so the start of a name must not be referenced after its input buffer
+    for (char c : doc)
+    {
+        buffer[0] = c;
+        extractor.parse_bytes(std::string_view(buffer, 1));
+        buffer[0] = '#';
+    }
+    REQUIRE(inner == 17);
+}
+
+struct contiguous_traits : a::default_traits
+{
+    static constexpr bool contiguous_strings = true;
+};
+
+TEST_CASE("JSON Path: contiguous strings from a spill buffer")
+{
+    std::string_view const doc = R"({"long_member_name":{"other":"text","inner":"split value"}} )";
+    std::string            inner;
+    std::vector<int>       fragments;
+    auto                   extractor = a::make_extractor<contiguous_traits>(
+        [](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; },
+        a::path(
+            [&](auto const& ev) {
+                if (ev.event == a::saj_event::string_value_start) inner.assign(ev.as_string_view().begin(), ev.as_string_view().end());
+                if (ev.event == a::saj_event::string_value_cont) fragments.push_back(1);
+            },
+            "long_member_name", "inner"));
+    for (size_t i = 0; i != doc.size(); i += 3) extractor.parse_bytes(doc.substr(i, 3));
+    REQUIRE(inner == "split value");
+    REQUIRE(fragments.empty());
+}
+
+struct decoding_traits : a::default_traits
+{
+    static constexpr bool decode_escapes = true;
+};
+
+TEST_CASE("JSON Path: decoded names and strings split across input buffers")
+{
+    std::string_view const doc = R"({"n\u0061me":"x\ty\u00e9","o\"k":{"v\\":"\u0041"}} )";
+    for (size_t split = 1; split != doc.size(); ++split)
+    {
+        std::string      name, inner;
+        std::string_view view;
+        auto             extractor = a::make_extractor<decoding_traits>(
+            [](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; }, a::path(a::assign_string(name), "name"),
+            a::path(a::assign_view(view), "name"), a::path(a::assign_string(inner), "o\"k", "v\\"));
+        std::string input(doc.substr(0, split));
+        extractor.parse_bytes(input);
+        input.assign(input.size(), 'x');  // the input buffer is reused before the document is complete
+        input = doc.substr(split);
+        extractor.parse_bytes(input);
+        REQUIRE(name == "x\ty\xc3\xa9");
+        REQUIRE(view == name);
+        REQUIRE(inner == "A");
+    }
+}
+
+TEST_CASE("JSON Path: many paths")
+{
+    std::string      doc = "{";
+    std::vector<long> values(64, -1);
+    for (int i = 0; i != 64; ++i) doc += (i ? ",\"k" : "\"k") + std::to_string(i) + "\":{\"v\":" + std::to_string(i * 3) + "}";
+    doc += "} ";
+    std::vector<std::string> names;
+    for (int i = 0; i != 64; ++i) names.push_back("k" + std::to_string(i));
+    auto at = [&](int i) { return a::path(a::assign_numeric(values[i]), std::string_view(names[i]), "v"); };
+    auto extractor = a::make_extractor([](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; }, at(0), at(1),
+                                       at(7), at(8), at(9), at(10), at(31), at(63));
+    extractor.parse_bytes(doc);
+    for (int i : {0, 1, 7, 8, 9, 10, 31, 63}) REQUIRE(values[i] == i * 3);
+    REQUIRE(values[2] == -1);
+}
+
+TEST_CASE("JSON Path: perfect hash member dispatch")
+{
+    std::vector<std::string> names;
+    for (int i = 0; i != 300; ++i) names.push_back("member_" + std::to_string(i * 7919));
+    names.push_back("a");
+    names.push_back("abcdefgh");
+    names.push_back("abcdefghijklmnop");
+    names.push_back("abcdefghijklmnopq");
+
+    a::detail::path_trie<> trie;
+    for (size_t i = 0; i != names.size(); ++i)
+    {
+        a::detail::path_element pe(std::string_view{names[i]});
+        trie.insert(&pe, &pe + 1, static_cast<uint32_t>(i));
+    }
+    trie.build();
+    auto lookup = [&](std::string_view name) {
+        long found = -1;
+        trie.match_member(trie.root, a::detail::fnv1a(name), name,
+                          [&](uint32_t n) { trie.for_each_action(n, [&](uint32_t action) { found = static_cast<long>(action); }); });
+        return found;
+    };
+    for (size_t i = 0; i != names.size(); ++i) REQUIRE(lookup(names[i]) == static_cast<long>(i));
+    REQUIRE(lookup("abcdefghijklmnoX") == -1);
+    REQUIRE(lookup("abcdefgX") == -1);
+    REQUIRE(lookup("member_") == -1);
+    REQUIRE(lookup("") == -1);
+    REQUIRE(a::detail::fnv1a("defgh", a::detail::fnv1a("abc")) == a::detail::fnv1a("abcdefgh"));
+}
+
+TEST_CASE("JSON Path: perfect hash built at compile time")
+{
+    constexpr auto trie = [] {
+        a::detail::path_trie<4, 3>    t;
+        a::detail::path_element const first[]  = {"a", "b"};
+        a::detail::path_element const second[] = {"a", "c"};
+        a::detail::path_element const third[]  = {"d"};
+        t.insert(first, first + 2, 0);
+        t.insert(second, second + 2, 1);
+        t.insert(third, third + 1, 2);
+        t.build();
+        return t;
+    }();
+    static_assert(trie.names == 4);
+    auto lookup = [&](std::initializer_list<std::string_view> path) {
+        uint32_t node = trie.root;
+        for (auto name : path)
+        {
+            uint32_t next = 0;
+            trie.match_member(node, a::detail::fnv1a(name), name, [&](uint32_t n) { next = n; });
+            if (!next) return -1l;
+            node = next;
+        }
+        long found = -1;
+        trie.for_each_action(node, [&](uint32_t action) { found = static_cast<long>(action); });
+        return found;
+    };
+    REQUIRE(lookup({"a", "b"}) == 0);
+    REQUIRE(lookup({"a", "c"}) == 1);
+    REQUIRE(lookup({"d"}) == 2);
+    REQUIRE(lookup({"a", "d"}) == -1);
+    REQUIRE(lookup({"b"}) == -1);
+}
+
+TEST_CASE("JSON Path: member names with colliding hashes")
+{
+    a::detail::path_trie<> trie;
+    std::vector<std::string> names;
+    for (int i = 0; i != 8; ++i) names.push_back("name" + std::to_string(i));
+    for (uint32_t i = 0; i != names.size(); ++i)
+    {
+        a::detail::path_element const element[] = {std::string_view(names[i])};
+        trie.insert(element, element + 1, i);
+    }
+    // an FNV-1a collision gives every name the same hash, no displacement can separate them
+    uint64_t const shared = a::detail::fnv1a("name0");
+    for (auto& n : trie.nodes)
+        if (n.parent == trie.root && n.selector.type == a::detail::path_type::string) n.hash = shared;
+    trie.build();
+    for (uint32_t i = 0; i != names.size(); ++i)
+    {
+        std::vector<uint32_t> actions;
+        trie.match_member(trie.root, shared, names[i], [&](uint32_t n) { trie.for_each_action(n, [&](uint32_t a) { actions.push_back(a); }); });
+        REQUIRE(actions == std::vector<uint32_t>{i});
+    }
+    uint32_t unknown = 0;
+    trie.match_member(trie.root, shared, "other", [&](uint32_t) { ++unknown; });
+    REQUIRE(unknown == 0);
+}
+
+TEST_CASE("JSON Path: path literals without allocation")
+{
+    constexpr auto literal = a::path([](auto const&) {}, "bar", a::arbitrary, "foo");
+    static_assert(literal.elements.size() == 3);
+    static_assert(literal.elements[0].str == "bar");
+    static_assert(literal.elements[1].type == a::detail::path_type::arbitrary);
+    static_assert(std::is_trivially_destructible_v<std::decay_t<decltype(literal)>>);
+
+    constexpr char val[] = R"({"bar":{"x":{"foo":7},"y":{"foo":8}}} )";
+    long           sum   = 0;
+    auto extractor = a::make_extractor([](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; },
+                                       a::path([&sum](auto const& ev) { sum += ev.as_number(); }, "bar", a::arbitrary, "foo"));
+    using matcher_t = std::decay_t<decltype(extractor.callback_handler()->matcher)>;
+    static_assert(!std::is_same_v<matcher_t, a::detail::path_matcher<a::default_traits>>);
+    extractor.parse_bytes(std::string_view(val, sizeof(val)));
+    REQUIRE(sum == 15);
+}
+
+TEST_CASE("JSON Path: is_path matcher")
+{
+    constexpr char val[] = R"({"bar":{"foo":5}} )";
+    auto           test  = a::is_path("bar", "foo");
+    long           foo   = 0;
+    auto extractor = a::make_extractor([](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; },
+                                       [&](auto const& ev) {
+                                           if (test(ev) && ev.event == a::saj_event::integer_value) foo = ev.as_number();
+                                       });
+    extractor.parse_bytes(std::string_view(val, sizeof(val)));
+    REQUIRE(foo == 5);
+}
+
+TEST_CASE("JSON Path: array index, slice and each")
+{
+    std::string_view const doc = R"({"results":[{"id":1,"tags":["a","b"]},{"id":2},{"id":3,"tags":["c"]},{"id":4}],"m":[[1,2],[3,4]],"n":5} )";
+    std::vector<long>        first_two, all;
+    std::vector<std::string> tags;
+    long                     fourth = 0, m10 = 0;
+    auto                     make   = [&] {
+        return a::make_extractor([](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; },
+                                 a::path([&](auto const& ev) { first_two.push_back(ev.as_number()); }, "results", a::slice(0, 2), "id"),
+                                 a::path([&](auto const& ev) { all.push_back(ev.as_number()); }, "results", a::each, "id"),
+                                 a::path(a::assign_numeric(fourth), "results", a::index(3), "id"),
+                                 a::path(a::assign_numeric(m10), "m", a::index(1), a::index(0)),
+                                 a::path(
+                                     [&](auto const& ev) {
+                                         if (ev.event == a::saj_event::string_value_start) tags.emplace_back(ev.as_string_view());
+                                         if (ev.event == a::saj_event::string_value_cont) tags.back() += ev.as_string_view();
+                                     },
+                                     "results", a::each, "tags", a::index(0)));
+    };
+    auto whole = make();
+    whole.parse_bytes(doc);
+    REQUIRE(first_two == std::vector<long>{1, 2});
+    REQUIRE(all == std::vector<long>{1, 2, 3, 4});
+    REQUIRE(tags == std::vector<std::string>{"a", "c"});
+    REQUIRE(fourth == 4);
+    REQUIRE(m10 == 3);
+
+    first_two.clear(), all.clear(), tags.clear(), fourth = 0, m10 = 0;
+    auto bytewise = make();
+    for (size_t i = 0; i != doc.size(); ++i) bytewise.parse_bytes(doc.substr(i, 1));
+    REQUIRE(first_two == std::vector<long>{1, 2});
+    REQUIRE(all == std::vector<long>{1, 2, 3, 4});
+    REQUIRE(tags == std::vector<std::string>{"a", "c"});
+    REQUIRE(fourth == 4);
+    REQUIRE(m10 == 3);
+}
+
+TEST_CASE("JSON Path: values outside of all paths are skipped")
+{
+    using ev_t = a::saj_event_value<a::default_traits>;
+    a::detail::path_matcher<a::default_traits> matcher;
+    a::detail::path_element const              path[] = {"results", a::slice(0, 2), "id"};
+    matcher.add_path(std::begin(path), std::end(path), 0);
+    matcher.build();
+
+    std::vector<long> ids;
+    auto              feed = [&](ev_t const& ev) {
+        return matcher.process_event(ev, [&](uint32_t, ev_t const& e) {
+            if (e.event == a::saj_event::integer_value) ids.push_back(e.as_number());
+        });
+    };
+    auto name = [&](std::string_view n) {
+        feed(ev_t(a::saj_event::object_name_start, n));
+        return feed(ev_t(a::saj_event::object_name_end));
+    };
+    auto const skip    = a::parse_verdict::skip;
+    auto const proceed = a::parse_verdict::proceed;
+    REQUIRE(feed(ev_t(a::saj_event::object_start)) == proceed);
+    REQUIRE(name("other") == skip);
+    REQUIRE(name("results") == proceed);
+    REQUIRE(feed(ev_t(a::saj_event::array_start)) == proceed);
+    for (long i = 0; i != 4; ++i)
+    {
+        REQUIRE(feed(ev_t(a::saj_event::object_start)) == (i < 2 ? proceed : skip));
+        if (i < 2)
+        {
+            REQUIRE(name("id") == proceed);
+            feed(ev_t(a::saj_event::integer_value, i));
+            REQUIRE(name("name") == skip);
+        }
+        feed(ev_t(a::saj_event::object_end));
+    }
+    feed(ev_t(a::saj_event::array_end));
+    feed(ev_t(a::saj_event::object_end));
+    REQUIRE(ids == std::vector<long>{0, 1});
+}
+
+TEST_CASE("JSON Path: descendants at any depth")
+{
+    auto report_error = [](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; };
+    std::string_view const doc =
+        R"({"trace_id":1,"event":{"trace_id":2,"payload":[{"trace_id":3},[{"x":{"trace_id":4}}]]},"other":{"span":{"trace_id":5}}} )";
+    std::vector<long> ids;
+    std::vector<long> spans;
+    auto              extractor = a::make_extractor(
+        report_error, a::path([&](auto const& ev) { ids.push_back(ev.as_number()); }, a::descendants, "trace_id"),
+        a::path([&](auto const& ev) { spans.push_back(ev.as_number()); }, "other", a::descendants, "span", "trace_id"));
+    extractor.parse_bytes(doc);
+    REQUIRE(ids == std::vector<long>{1, 2, 3, 4, 5});
+    REQUIRE(spans == std::vector<long>{5});
+}
+
+TEST_CASE("JSON Path: nested matches of descendants deliver each event once")
+{
+    auto report_error = [](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; };
+    std::string_view const doc = R"({"a":{"a":{"a":1}},"b":[{"a":2},{"c":[3,{"a":4}]}]} )";
+    std::vector<long>      numbers;
+    int                    objects = 0;
+    auto                   extractor =
+        a::make_extractor(report_error, a::path(
+                                            [&](auto const& ev) {
+                                                if (ev.event == a::saj_event::integer_value) numbers.push_back(ev.as_number());
+                                                if (ev.event == a::saj_event::object_start) ++objects;
+                                            },
+                                            a::descendants, "a", a::descendants, "a"));
+    extractor.parse_bytes(doc);
+    // only {"a":1} and 1 have an "a" above them
+    REQUIRE(numbers == std::vector<long>{1});
+    REQUIRE(objects == 1);
+
+    std::vector<long> elements;
+    auto              second = a::make_extractor(
+        report_error, a::path(
+                          [&](auto const& ev) {
+                              if (ev.event == a::saj_event::integer_value) elements.push_back(ev.as_number());
+                          },
+                          a::descendants, a::index(0)));
+    second.parse_bytes(doc);
+    // {"a":2} and 3 are first elements
+    REQUIRE(elements == std::vector<long>{2, 3});
+}
+
+TEST_CASE("JSON Path: string views into the extractor arena")
+{
+    auto report_error = [](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; };
+    std::string_view              name, copy;
+    std::vector<std::string_view> tags;
+    long                          id = 0;
+    auto                          extractor =
+        a::make_extractor(report_error, a::path(a::assign_view(name), "name"), a::path(a::assign_view(copy), "name"),
+                          a::path(a::append_views(tags), "tags", a::each), a::path(a::assign_numeric(id), "id"));
+
+    std::string input = R"({"id":1,"name":"a long na)";
+    extractor.parse_bytes(input);
+    input.assign(input.size(), 'x');  // the input buffer is reused before the document is complete
+    input = R"(me","skip":"not stored","tags":["x","y)";
+    extractor.parse_bytes(input);
+    input.assign(input.size(), 'x');
+    input = R"(z",""]} )";
+    extractor.parse_bytes(input);
+    input.assign(input.size(), 'x');
+
+    REQUIRE(id == 1);
+    REQUIRE(name == "a long name");
+    REQUIRE(copy.data() == name.data());
+    REQUIRE(tags == std::vector<std::string_view>{"x", "yz", ""});
+    auto& arena = extractor.callback_handler()->arena;
+    REQUIRE(arena.capacity() >= 14);
+
+    SECTION("reset keeps the storage for the next document")
+    {
+        std::string large(3 * arena.capacity(), 'l');
+        extractor.reset();
+        extractor.parse_bytes(R"({"name":")" + large + R"(","tags":[")" + large + R"("]} )");
+        REQUIRE(name == large);
+        REQUIRE(tags.back() == large);
+        auto const capacity = arena.capacity();
+        for (int i = 0; i != 3; ++i)
+        {
+            tags.clear();
+            extractor.reset();
+            extractor.parse_bytes(R"({"name":")" + large + R"(","tags":[")" + large + R"("]} )");
+            REQUIRE(arena.capacity() == capacity);
+            REQUIRE(name == large);
+            REQUIRE(tags == std::vector<std::string_view>{large});
+        }
+    }
+}
+
+TEST_CASE("JSON Path: only strings of actions that take the arena are copied")
+{
+    auto report_error = [](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; };
+    std::string_view name;
+    std::string      body;
+    auto extractor = a::make_extractor(report_error, a::path(a::assign_view(name), "name"), a::path(a::assign_string(body), "body"));
+    std::string const large(64 * 1024, 'b');
+    extractor.parse_bytes(R"({"body":")" + large + R"(","name":"n"} )");
+    REQUIRE(body == large);
+    REQUIRE(name == "n");
+    REQUIRE(extractor.callback_handler()->arena.capacity() < large.size());
+}
@@ -0,0 +1,330 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <async_json/basic_json_parser.hpp>
+#include <async_json/json_validator.hpp>
+#include <async_json/saj_event_batcher.hpp>
+#include <async_json/saj_event_mapper.hpp>
+#include <async_json/string_converter.hpp>
+#include "baseline_json_parser.hpp"
+#include "catch.hpp"
+
+namespace a = async_json;
+
+namespace
+{
+struct counting_handler : a::default_handler<a::default_traits>
+{
+    using sv_t = a::default_traits::sv_t;
+    size_t events{0};
+    void   value(bool) { ++events; }
+    void   value(void*) { ++events; }
+    void   value(long) { ++events; }
+    void   value(double) { ++events; }
+    void   value(sv_t const&) { ++events; }
+    void   named_object(sv_t const&) { ++events; }
+    void   object_start() { ++events; }
+    void   object_end() { ++events; }
+    void   array_start() { ++events; }
+    void   array_end() { ++events; }
+};
+
+struct indexed_traits : a::default_traits
+{
+    static constexpr bool structural_index = true;
+};
+
+std::string large_document()
+{
+    std::string doc = "[";
+    for (int i = 0; i != 1000; ++i)
+        doc += R"({"id": 1234, "name": "a rather long name of a sensor that is located somewhere", "tags": ["alpha", "beta"]},)"
+               "\n    ";
+    doc += "null] ";
+    return doc;
+}
+
+struct per_event_sum : a::saj_event_mapper<per_event_sum>
+{
+    long sum{0};
+    void process_event(a::saj_event_value<a::default_traits> const& ev)
+    {
+        if (ev.event == a::saj_event::integer_value) sum += ev.as_number();
+    }
+};
+
+struct batched_sum : a::saj_event_batcher<batched_sum>
+{
+    long sum{0};
+    void handle_batch(a::saj_event_batch<a::default_traits> const& batch)
+    {
+        for (auto const& ev : batch)
+            if (ev.event == a::saj_event::integer_value) sum += ev.as_number();
+    }
+};
+
+/// the previous json_to_utf8, which replaced every escape sequence in place and moved the rest of the string each time
+std::string& replace_per_escape(std::string& str)
+{
+    enum escape_state
+    {
+        none,
+        bs,
+        uhex1,
+        uhex2,
+        uhex3,
+        uhex4,
+        hex_done
+    };
+    escape_state       es{none};
+    unsigned int const factors[4]        = {12u, 8u, 4u, 0u};
+    int                codepoint         = 0;
+    auto*              factor            = factors;
+    auto               consume_codepoint = [&str, &factor, &es](int& cp, size_t i) -> bool {
+        if (a::detail::is_hex(str[i]))
+        {
+            cp += static_cast<int>(a::detail::from_hex(str[i]) << *factor++);
+            es = static_cast<decltype(es)>(static_cast<int>(es) + 1);
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    };
+    for (size_t i = 0; i != str.size(); ++i)
+    {
+        switch (es)
+        {
+            case none:
+                if (str[i] == '\\') es = bs;
+                break;
+            case bs:
+            {
+                char const* rep = nullptr;
+                switch (str[i])
+                {
+                    case '\\': rep = "\\"; break;
+                    case 'b': rep = "\b"; break;
+                    case 't': rep = "\t"; break;
+                    case 'r': rep = "\r"; break;
+                    case 'n': rep = "\n"; break;
+                    case '"': rep = "\""; break;
+                    case 'u':
+                        if (str.size() - i < 4) return str;  // with error
+                        es        = uhex1;
+                        factor    = factors;
+                        codepoint = 0;
+                        continue;
+                    default: return str;  // with error;
+                }
+                if (rep)
+                {
+                    str.replace(--i, 2, rep);
+                    --i;
+                    es = none;
+                }
+                break;
+            }
+            case uhex1:
+            case uhex2:
+            case uhex3:
+            case uhex4:
+                if (!consume_codepoint(codepoint, i)) return str;  // error
+                if (es == hex_done)
+                {
+                    size_t chars_to_replace = 6;
+                    // two consecutive codepoints:
+                    if (0xD800 <= codepoint && codepoint <= 0xDBFF)
+                    {
+                        chars_to_replace += 6;
+                        int cp2 = 0;
+                        es      = uhex1;
+                        factor  = factors;
+                        if (i + 6 < str.size() && str[i + 1] == '\\' && str[i + 2] == 'u' && consume_codepoint(cp2, i + 3) &&
+                            consume_codepoint(cp2, i + 4) && consume_codepoint(cp2, i + 5) && consume_codepoint(cp2, i + 6))
+                        {
+                            if (0xDC00 <= cp2 && cp2 <= 0xDFFF)
+                                // overwrite codepoint
+                                codepoint = static_cast<int>(
+                                    // high surrogate occupies the most significant 22 bits
+                                    (static_cast<unsigned int>(codepoint) << 10u)
+                                    // low surrogate occupies the least significant 15 bits
+                                    + static_cast<unsigned int>(cp2)
+                                    // there is still the 0xD800, 0xDC00 and 0x10000 noise
+                                    // in the result so we have to subtract with:
+                                    // (0xD800 << 10) + DC00 - 0x10000 = 0x35FDC00
+                                    - 0x35FDC00u);
+                            else
+                                return str;  // error
+                        }
+                        else
+                        {
+                            return str;  // error
+                        }
+                    }
+                    else if (0xDC00 <= codepoint && codepoint <= 0xDFFF)
+                        return str;  // error
+                    char array[5]        = {0, 0, 0, 0, 0};
+                    auto replacement_pos = i - 5;
+                    if (codepoint < 0x80)
+                    {
+                        array[0] = static_cast<char>(codepoint);
+                        str.replace(replacement_pos, chars_to_replace, array);
+                        i -= 6;
+                    }
+                    else if (codepoint <= 0x7FF)
+                    {
+                        array[0] = static_cast<char>(0xC0u | (static_cast<unsigned int>(codepoint) >> 6u));
+                        array[1] = static_cast<char>(0x80u | (static_cast<unsigned int>(codepoint) & 0x3Fu));
+                        str.replace(replacement_pos, chars_to_replace, array);
+                        i -= 5;
+                    }
+                    else if (codepoint <= 0xFFFF)
+                    {
+                        // 3-byte characters: 1110xxxx 10xxxxxx 10xxxxxx
+                        array[0] = static_cast<char>(0xE0u | (static_cast<unsigned int>(codepoint) >> 12u));
+                        array[1] = static_cast<char>(0x80u | ((static_cast<unsigned int>(codepoint) >> 6u) & 0x3Fu));
+                        array[2] = static_cast<char>(0x80u | (static_cast<unsigned int>(codepoint) & 0x3Fu));
+                        str.replace(replacement_pos, chars_to_replace, array);
+                        i -= 4;
+                    }
+                    else
+                    {
+                        // 4-byte characters: 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+                        array[0] = static_cast<char>(0xF0u | (static_cast<unsigned int>(codepoint) >> 18u));
+                        array[1] = static_cast<char>(0x80u | ((static_cast<unsigned int>(codepoint) >> 12u) & 0x3Fu));
+                        array[2] = static_cast<char>(0x80u | ((static_cast<unsigned int>(codepoint) >> 6u) & 0x3Fu));
+                        array[3] = static_cast<char>(0x80u | (static_cast<unsigned int>(codepoint) & 0x3Fu));
+                        str.replace(replacement_pos, chars_to_replace, array);
+                        i -= 3;
+                    }
+                    es        = none;
+                }
+                break;
+            default: break;
+        }
+    }
+    return str;
+}
+
+/// about size bytes of escaped text with an \" behind every run of plain characters, every fourth one is \u00e9 instead
+std::string escaped_text(size_t size, size_t run)
+{
+    std::string text;
+    for (size_t i = 0; text.size() < size; ++i)
+    {
+        text.append(run, 'x');
+        text += i % 4 ? R"(\")" : R"(\u00e9)";
+    }
+    return text;
+}
+
+constexpr std::string_view small_message = R"({"id":1234,"ok":true,"name":"sensor-7","values":[1,2,3]} )";
+}  // namespace
+
+TEST_CASE("Benchmark: small messages")
+{
+    BENCHMARK("new parser per message")
+    {
+        a::basic_json_parser<counting_handler> p;
+        p.parse_bytes(small_message);
+        return p.callback_handler()->events;
+    };
+
+    a::basic_json_parser<counting_handler> reused;
+    BENCHMARK("reused parser")
+    {
+        reused.reset();
+        reused.parse_bytes(small_message);
+        return reused.callback_handler()->events;
+    };
+
+    // the parser used to own its state machine through a heap allocated std::function
+    BENCHMARK("baseline parser per message")
+    {
+        a::baseline::basic_json_parser<counting_handler> p;
+        p.parse_bytes(small_message);
+        return p.callback_handler()->events;
+    };
+
+    a::baseline::basic_json_parser<counting_handler> reused_baseline;
+    BENCHMARK("reused baseline parser")
+    {
+        reused_baseline.reset();
+        reused_baseline.parse_bytes(small_message);
+        return reused_baseline.callback_handler()->events;
+    };
+}
+
+TEST_CASE("Benchmark: large document")
+{
+    std::string const                                          doc = large_document();
+    a::basic_json_parser<counting_handler>                     bytewise;
+    a::basic_json_parser<counting_handler, indexed_traits> indexed;
+    BENCHMARK("byte wise parser")
+    {
+        bytewise.reset();
+        bytewise.parse_bytes(doc);
+        return bytewise.callback_handler()->events;
+    };
+    BENCHMARK("structural index parser")
+    {
+        indexed.reset();
+        indexed.parse_bytes(doc);
+        return indexed.callback_handler()->events;
+    };
+    a::json_validator validator;
+    BENCHMARK("validator")
+    {
+        validator.reset();
+        return validator.parse_bytes(doc) && validator.complete();
+    };
+}
+
+TEST_CASE("Benchmark: many small scalars")
+{
+    std::string doc = "[";
+    for (int i = 0; i != 10000; ++i) doc += std::to_string(i % 100) + ",";
+    doc += "0] ";
+    BENCHMARK("event per callback")
+    {
+        a::basic_json_parser<per_event_sum> p;
+        p.parse_bytes(doc);
+        return p.callback_handler()->sum;
+    };
+    BENCHMARK("batched events")
+    {
+        a::basic_json_parser<batched_sum> p;
+        p.parse_bytes(doc);
+        return p.callback_handler()->sum;
+    };
+}
+
+TEST_CASE("Benchmark: json_to_utf8")
+{
+    size_t const size = 16 * 1024;
+    // from plain text to windows paths and JSON in JSON, where every other character may be escaped
+    for (size_t run : {size, size_t{100}, size_t{10}, size_t{1}})
+    {
+        std::string const text     = escaped_text(size, run);
+        std::string const label    = ", " + std::to_string(run) + " plain bytes per escape sequence";
+        std::string       expected = text;
+        REQUIRE(a::json_to_utf8(text) == replace_per_escape(expected));
+        BENCHMARK("replace per escape" + label)
+        {
+            std::string str = text;
+            return replace_per_escape(str).size();
+        };
+        BENCHMARK("single pass in place" + label)
+        {
+            std::string str = text;
+            return a::json_to_utf8(str).size();
+        };
+        std::string out;
+        BENCHMARK("single pass into reused output" + label)
+        {
+            out.clear();
+            return a::json_to_utf8(std::string_view(text), out).size();
+        };
+    }
+}
@@ -18,7 +18,8 @@ enum class call_type
     array_end,
     string_value,
     integer_value,
-    double_value
+    double_value,
+    number_text
 };
 
 constexpr const char* error_str(a::error_cause cause);
@@ -45,6 +46,7 @@ struct call
             case call_type::string_value: return o << '"' << rhs.buf << '"';
             case call_type::integer_value: return o << rhs.value;
             case call_type::double_value: return o << rhs.float_val;
+            case call_type::number_text: return o << rhs.buf;
         }
         return o;
     }
@@ -67,6 +69,7 @@ constexpr const char* error_str(a::error_cause cause)
         case a::unexpected_character: return "unexpected character";
         case a::comma_expected: return "comma expected";
         case a::invalid_number: return "invalid character in number";
+        case a::integer_overflow: return "integer overflow";
         default: return "no error";
     }
 }
@@ -78,6 +81,42 @@ struct sp_float
     using sv_t      = async_json::default_traits::sv_t;
 };
 
+struct raw_number_traits : a::default_traits
+{
+    static constexpr bool raw_numbers = true;
+};
+
+struct indexed_traits : a::default_traits
+{
+    static constexpr bool structural_index = true;
+};
+
+struct contiguous_traits : a::default_traits
+{
+    static constexpr bool contiguous_strings = true;
+};
+
+struct indexed_contiguous_traits : indexed_traits
+{
+    static constexpr bool contiguous_strings = true;
+};
+
+template <typename Base>
+struct decoding_traits : Base
+{
+    static constexpr bool decode_escapes = true;
+};
+
+template <a::overflow_policy policy, typename Integer = long>
+struct overflow_traits
+{
+    using float_t   = double;
+    using integer_t = Integer;
+    using sv_t      = async_json::default_traits::sv_t;
+
+    static constexpr a::overflow_policy integer_overflow_policy = policy;
+};
+
 template <typename T = async_json::default_traits>
 struct test_handler
 {
@@ -89,8 +128,9 @@ struct test_handler
 
     void value(bool a) { calls.push_back(call{call_type::boolean, ptrdiff_t(a)}); }
     void value(float_t n) { std::cout << n<< " " << static_cast<double>(n) << std::endl; calls.push_back(call{call_type::double_value, 0, "", n}); }
-    void value(integer_t n) { calls.push_back(call{call_type::integer_value, n}); }
+    void value(integer_t n) { calls.push_back(call{call_type::integer_value, ptrdiff_t(n)}); }
     void value(sv_t const& a) { calls.push_back(call{call_type::string_value, 0, std::string(a.begin(), a.end())}); }
+    void number_value(sv_t const& a) { calls.push_back(call{call_type::number_text, 0, std::string(a.begin(), a.end())}); }
     void string_value_start(sv_t const& a) { calls.push_back(call{call_type::string_value, 0, std::string(a.begin(), a.end())}); }
     void string_value_cont(sv_t const& a) { calls.back().buf += std::string(a.begin(), a.end()); }
     void string_value_end() {}
@@ -112,6 +152,43 @@ struct test_handler
     }
 };
 
+template <typename T = async_json::default_traits>
+struct skipping_handler : test_handler<T>
+{
+    using base = test_handler<T>;
+    using sv_t = typename T::sv_t;
+    std::string name;
+
+    a::parse_verdict verdict(char const* skipped) const { return name == skipped ? a::parse_verdict::skip : a::parse_verdict::proceed; }
+    a::parse_verdict named_object(sv_t const& n)
+    {
+        base::named_object(n);
+        name.assign(n.begin(), n.end());
+        return verdict("skip");
+    }
+    void named_object_start(sv_t const& n)
+    {
+        base::named_object_start(n);
+        name.assign(n.begin(), n.end());
+    }
+    void named_object_cont(sv_t const& n)
+    {
+        base::named_object_cont(n);
+        name.append(n.begin(), n.end());
+    }
+    a::parse_verdict named_object_end() { return verdict("skip"); }
+    a::parse_verdict object_start()
+    {
+        base::object_start();
+        return verdict("skip content");
+    }
+    a::parse_verdict array_start()
+    {
+        base::array_start();
+        return verdict("skip content");
+    }
+};
+
 TEST_CASE("Detect keywords: null")
 {
     char const                           input_buffer[] = "   null   ";
@@ -395,3 +472,421 @@ TEST_CASE("escape sequences")
 }
 
 
+
+TEST_CASE("partial input byte by byte")
+{
+    using namespace std::literals;
+    auto const                           input = R"( { "na\"me": "va\\lue", "list": [ 12, -3.5, true, null ] } )"sv;
+    a::basic_json_parser<test_handler<>> p;
+    for (size_t i = 0; i != input.size(); ++i) p.parse_bytes(input.substr(i, 1));
+    REQUIRE_THAT(p.callback_handler()->calls, Catch::Matchers::Equals(std::vector<call>{{call_type::object_start},
+                                                                                        {call_type::named_object, 0, R"(na\"me)"},
+                                                                                        {call_type::string_value, 0, R"(va\\lue)"},
+                                                                                        {call_type::named_object, 0, "list"},
+                                                                                        {call_type::array_start},
+                                                                                        {call_type::integer_value, 12},
+                                                                                        {call_type::double_value, 0, "", -3.5},
+                                                                                        {call_type::boolean, 1},
+                                                                                        {call_type::obj_ref, 0},
+                                                                                        {call_type::array_end},
+                                                                                        {call_type::object_end}}));
+}
+
+TEST_CASE("long string values")
+{
+    using namespace std::literals;
+    std::string const long_text(100, 'x');
+    for (size_t esc_pos : {0u, 7u, 15u, 16u, 31u, 32u, 33u, 63u, 99u})
+    {
+        std::string value = long_text;
+        value.insert(esc_pos, R"(\")");
+        std::string const input = R"({")" + long_text + R"(": ")" + value + R"("} )";
+        for (size_t split : {size_t{1}, size_t{17}, size_t{64}, size_t{110}, input.size()})
+        {
+            a::basic_json_parser<test_handler<>> p;
+            p.parse_bytes(std::string_view(input).substr(0, split));
+            p.parse_bytes(std::string_view(input).substr(split));
+            REQUIRE_THAT(p.callback_handler()->calls, Catch::Matchers::Equals(std::vector<call>{{call_type::object_start},
+                                                                                                {call_type::named_object, 0, long_text},
+                                                                                                {call_type::string_value, 0, value},
+                                                                                                {call_type::object_end}}));
+        }
+    }
+}
+
+TEST_CASE("pretty printed input")
+{
+    using namespace std::literals;
+    std::string const indent(40, ' ');
+    std::string const input = "{\n" + indent + "\"a\"\t :  [\n" + indent + "1 ,\r\n" + indent + "-2\n" + indent + "]\n" + indent + "} ";
+    for (size_t split = 1; split < input.size(); split += 7)
+    {
+        a::basic_json_parser<test_handler<>> p;
+        p.parse_bytes(std::string_view(input).substr(0, split));
+        p.parse_bytes(std::string_view(input).substr(split));
+        REQUIRE_THAT(p.callback_handler()->calls, Catch::Matchers::Equals(std::vector<call>{{call_type::object_start},
+                                                                                            {call_type::named_object, 0, "a"},
+                                                                                            {call_type::array_start},
+                                                                                            {call_type::integer_value, 1},
+                                                                                            {call_type::integer_value, -2},
+                                                                                            {call_type::array_end},
+                                                                                            {call_type::object_end}}));
+    }
+}
+
+TEST_CASE("Number: minus sign without digits")
+{
+    using namespace std::literals;
+    for (auto input : {"[1, - 2] "sv, "[1, -]"sv, "[1, -a] "sv})
+    {
+        for (size_t split = 1; split < input.size(); ++split)
+        {
+            a::basic_json_parser<test_handler<>> p;
+            if (p.parse_bytes(input.substr(0, split))) p.parse_bytes(input.substr(split));
+            REQUIRE_THAT(p.callback_handler()->calls, Catch::Matchers::Equals(std::vector<call>{{call_type::array_start},
+                                                                                                {call_type::integer_value, 1},
+                                                                                                {call_type::parse_error, a::invalid_number}}));
+        }
+    }
+}
+
+TEST_CASE("Number: correctly rounded doubles")
+{
+    using namespace std::literals;
+    std::pair<std::string_view, double> const cases[] = {{"0.1 "sv, 0.1},
+                                                         {"3.141592653589793 "sv, 3.141592653589793},
+                                                         {"1.7976931348623157e308 "sv, 1.7976931348623157e308},
+                                                         {"2.2250738585072014E-308 "sv, 2.2250738585072014e-308},
+                                                         {"4.9e-324 "sv, 4.9e-324},
+                                                         {"0.000000000000000000000000000001234 "sv, 1.234e-30},
+                                                         {"0.30000000000000004441 "sv, 0.30000000000000004441},
+                                                         {"1234567890123456789012345.5 "sv, 1234567890123456789012345.5},
+                                                         {"9007199254740993.0 "sv, 9007199254740993.0},
+                                                         {"12e25 "sv, 12e25},
+                                                         {"1.5e+2 "sv, 150.0},
+                                                         {"-0.0 "sv, -0.0}};
+    for (auto const& c : cases)
+    {
+        for (size_t split = 1; split <= c.first.size(); split += 3)
+        {
+            a::basic_json_parser<test_handler<>> p;
+            p.parse_bytes(c.first.substr(0, split));
+            p.parse_bytes(c.first.substr(split));
+            REQUIRE_THAT(p.callback_handler()->calls, Catch::Matchers::Equals(std::vector<call>{{call_type::double_value, 0, "", c.second}}));
+        }
+    }
+}
+
+TEST_CASE("Number: integer limits")
+{
+    using namespace std::literals;
+    a::basic_json_parser<test_handler<>> p;
+    p.parse_bytes("[9223372036854775807, -9223372036854775808, 9223372036854775808, -12345678901234567890123]"sv);
+    REQUIRE_THAT(p.callback_handler()->calls, Catch::Matchers::Equals(std::vector<call>{{call_type::array_start},
+                                                                                        {call_type::integer_value, INT64_MAX},
+                                                                                        {call_type::integer_value, INT64_MIN},
+                                                                                        {call_type::double_value, 0, "", 9223372036854775808.0},
+                                                                                        {call_type::double_value, 0, "", -12345678901234567890123.0},
+                                                                                        {call_type::array_end}}));
+}
+
+TEST_CASE("Number: unsigned 64 bit integers")
+{
+    using namespace std::literals;
+    using traits = overflow_traits<a::overflow_policy::promote_to_float, unsigned long long>;
+    a::basic_json_parser<test_handler<traits>, traits> p;
+    p.parse_bytes("[18446744073709551615, 184467440737"sv);
+    p.parse_bytes("09551616, -1]"sv);
+    REQUIRE_THAT(p.callback_handler()->calls, Catch::Matchers::Equals(std::vector<call>{{call_type::array_start},
+                                                                                        {call_type::integer_value, ptrdiff_t(UINT64_MAX)},
+                                                                                        {call_type::double_value, 0, "", 18446744073709551616.0},
+                                                                                        {call_type::double_value, 0, "", -1.0},
+                                                                                        {call_type::array_end}}));
+}
+
+TEST_CASE("Number: integer overflow as raw text")
+{
+    using namespace std::literals;
+    using traits = overflow_traits<a::overflow_policy::raw_text>;
+    a::basic_json_parser<test_handler<traits>, traits> p;
+    p.parse_bytes("[-9223372036854775809, 123456789012345678901234567890, 12]"sv);
+    REQUIRE_THAT(p.callback_handler()->calls, Catch::Matchers::Equals(std::vector<call>{{call_type::array_start},
+                                                                                        {call_type::number_text, 0, "-9223372036854775809"},
+                                                                                        {call_type::number_text, 0, "123456789012345678901234567890"},
+                                                                                        {call_type::integer_value, 12},
+                                                                                        {call_type::array_end}}));
+}
+
+TEST_CASE("Number: integer overflow as error")
+{
+    using namespace std::literals;
+    using traits = overflow_traits<a::overflow_policy::error, int>;
+    a::basic_json_parser<test_handler<traits>, traits> p;
+    CHECK(p.parse_bytes("[2147483647, -2147483648, "sv));
+    CHECK_FALSE(p.parse_bytes("2147483648]"sv));
+    REQUIRE_THAT(p.callback_handler()->calls, Catch::Matchers::Equals(std::vector<call>{{call_type::array_start},
+                                                                                        {call_type::integer_value, 2147483647},
+                                                                                        {call_type::integer_value, -2147483648},
+                                                                                        {call_type::parse_error, a::integer_overflow}}));
+}
+
+TEST_CASE("Number: raw number text")
+{
+    using namespace std::literals;
+    auto const input = R"({"a": [12, -3.5e+7, 123456789012345678901234567890 ,0.25], "b": -7})"sv;
+    for (size_t split = 1; split < input.size(); ++split)
+    {
+        a::basic_json_parser<test_handler<raw_number_traits>, raw_number_traits> p;
+        p.parse_bytes(input.substr(0, split));
+        p.parse_bytes(input.substr(split));
+        REQUIRE_THAT(p.callback_handler()->calls, Catch::Matchers::Equals(std::vector<call>{{call_type::object_start},
+                                                                                            {call_type::named_object, 0, "a"},
+                                                                                            {call_type::array_start},
+                                                                                            {call_type::number_text, 0, "12"},
+                                                                                            {call_type::number_text, 0, "-3.5e+7"},
+                                                                                            {call_type::number_text, 0, "123456789012345678901234567890"},
+                                                                                            {call_type::number_text, 0, "0.25"},
+                                                                                            {call_type::array_end},
+                                                                                            {call_type::named_object, 0, "b"},
+                                                                                            {call_type::number_text, 0, "-7"},
+                                                                                            {call_type::object_end}}));
+    }
+}
+
+TEST_CASE("structural index parser matches the byte wise parser")
+{
+    std::string const long_text(70, 'x');
+    std::string const blank(70, ' ');
+    std::vector<std::string> const inputs = {
+        R"({"a": [1, -2.5e+3, true, false, null], "b": {"c": "d"}} )",
+        R"({"esc": "a\"b\\", "run": "\\\\\"", "x\"y": "\\"} )",
+        "[" + blank + "\"" + long_text + "\"," + blank + "12345678901234567890123," + blank + "\"" + long_text + "\\\"" + long_text + "\"] ",
+        "{\"" + long_text + "\":" + blank + "-" + blank + "7" + blank + "} ",
+        "[1 2] ",
+        "[tr ue] ",
+        R"({"a" "b"} )",
+        "[\"a\",\\\"] ",
+        "[" + std::string(58, ' ') + "-1234567.5e-3, 1E5, 0.25, 18446744073709551616, 12345678901234567890123, true, false, null] ",
+        "{\"n\": [0, -0, 01, 1., 2.e3, 1e+, 3]} ",
+        "[" + std::string(61, ' ') + "truex] ",
+        "[nul] ",
+        "[-x] ",
+        "[12a] ",
+        "[1.5.2] ",
+        "42 ",
+    };
+    for (auto const& input : inputs)
+    {
+        for (size_t split = 0; split <= input.size(); ++split)
+        {
+            a::basic_json_parser<test_handler<>>                       bytewise;
+            a::basic_json_parser<test_handler<indexed_traits>, indexed_traits> indexed;
+            bool const ok_bytewise = bytewise.parse_bytes(std::string_view(input).substr(0, split)) &&
+                                     bytewise.parse_bytes(std::string_view(input).substr(split));
+            bool const ok_indexed = indexed.parse_bytes(std::string_view(input).substr(0, split)) &&
+                                    indexed.parse_bytes(std::string_view(input).substr(split));
+            INFO(input << " split at " << split);
+            CHECK(ok_bytewise == ok_indexed);
+            REQUIRE_THAT(indexed.callback_handler()->calls, Catch::Matchers::Equals(bytewise.callback_handler()->calls));
+        }
+    }
+}
+
+template <typename Traits>
+void check_skipping()
+{
+    std::string const long_text(100, 'x');
+    std::string const input = R"({"keep": 1, "skip": {"a": [1, "]}\"", {}], "b": "x"}, "skip": "str\"ing", "skip": -12.5e3,)"
+                              R"( "skip"  :  true , "skip": [")" + long_text + R"(]", [[)" + long_text.substr(0, 70) + R"(]], {"c": "}"}],)"
+                              R"( "skip content": {"x": [1, 2]}, "skip content": [[], "]"], "last": [true]} )";
+    std::vector<call> const expected{{call_type::object_start},
+                                     {call_type::named_object, 0, "keep"},
+                                     {call_type::integer_value, 1},
+                                     {call_type::named_object, 0, "skip"},
+                                     {call_type::named_object, 0, "skip"},
+                                     {call_type::named_object, 0, "skip"},
+                                     {call_type::named_object, 0, "skip"},
+                                     {call_type::named_object, 0, "skip"},
+                                     {call_type::named_object, 0, "skip content"},
+                                     {call_type::object_start},
+                                     {call_type::object_end},
+                                     {call_type::named_object, 0, "skip content"},
+                                     {call_type::array_start},
+                                     {call_type::array_end},
+                                     {call_type::named_object, 0, "last"},
+                                     {call_type::array_start},
+                                     {call_type::boolean, 1},
+                                     {call_type::array_end},
+                                     {call_type::object_end}};
+    for (size_t split = 0; split <= input.size(); ++split)
+    {
+        a::basic_json_parser<skipping_handler<Traits>, Traits> p;
+        INFO("split at " << split);
+        REQUIRE(p.parse_bytes(std::string_view(input).substr(0, split)));
+        REQUIRE(p.parse_bytes(std::string_view(input).substr(split)));
+        REQUIRE_THAT(p.callback_handler()->calls, Catch::Matchers::Equals(expected));
+    }
+    a::basic_json_parser<skipping_handler<Traits>, Traits> p;
+    for (size_t i = 0; i != input.size(); ++i) REQUIRE(p.parse_bytes(std::string_view(input).substr(i, 1)));
+    REQUIRE_THAT(p.callback_handler()->calls, Catch::Matchers::Equals(expected));
+}
+
+TEST_CASE("handler skips values and containers")
+{
+    check_skipping<a::default_traits>();
+    check_skipping<indexed_traits>();
+    check_skipping<contiguous_traits>();
+}
+
+template <typename Traits>
+void check_invalid_skipped(std::string_view input, a::error_cause cause)
+{
+    INFO(input);
+    for (size_t split = 0; split <= input.size(); ++split)
+    {
+        a::basic_json_parser<skipping_handler<Traits>, Traits> p;
+        INFO("split at " << split);
+        if (p.parse_bytes(input.substr(0, split))) REQUIRE_FALSE(p.parse_bytes(input.substr(split)));
+        auto const& calls = p.callback_handler()->calls;
+        REQUIRE(calls.size() == 3);
+        REQUIRE(calls.back() == call{call_type::parse_error, cause});
+    }
+}
+
+TEST_CASE("skipped numbers and keywords are validated")
+{
+    using namespace std::literals;
+    for (auto [input, cause] : {std::pair{R"({"skip":} )"sv, a::unexpected_character}, {R"({"skip":,"b":1} )"sv, a::unexpected_character},
+                                {R"({"skip":xyz} )"sv, a::unexpected_character}, {R"({"skip": -} )"sv, a::invalid_number},
+                                {R"({"skip":1x} )"sv, a::invalid_number}, {R"({"skip":12"s"} )"sv, a::invalid_number},
+                                {R"({"skip":1e} )"sv, a::invalid_number}, {R"({"skip":tru} )"sv, a::wrong_keyword_character},
+                                {R"({"skip":true1} )"sv, a::wrong_keyword_character}})
+    {
+        check_invalid_skipped<a::default_traits>(input, cause);
+        check_invalid_skipped<indexed_traits>(input, cause);
+    }
+}
+
+/// fails on fragments and counts the strings and names that were not copied out of the input buffer
+template <typename T>
+struct contiguous_handler : test_handler<T>
+{
+    using base = test_handler<T>;
+    using sv_t = typename T::sv_t;
+    std::string_view input;
+    size_t           fragments{0};
+    size_t           in_place{0};
+
+    void count(sv_t const& v) { in_place += !v.empty() && v.data() >= input.data() && v.data() < input.data() + input.size(); }
+    void value(sv_t const& v)
+    {
+        count(v);
+        base::value(v);
+    }
+    void named_object(sv_t const& n)
+    {
+        count(n);
+        base::named_object(n);
+    }
+    using base::value;
+    void string_value_start(sv_t const&) { ++fragments; }
+    void string_value_cont(sv_t const&) { ++fragments; }
+    void string_value_end() { ++fragments; }
+    void named_object_start(sv_t const&) { ++fragments; }
+    void named_object_cont(sv_t const&) { ++fragments; }
+    void named_object_end() { ++fragments; }
+};
+
+template <typename Traits>
+void check_contiguous_strings(std::string const& input)
+{
+    for (size_t split = 0; split <= input.size(); ++split)
+    {
+        a::basic_json_parser<test_handler<>>                               fragmented;
+        a::basic_json_parser<contiguous_handler<Traits>, Traits>           contiguous;
+        auto&                                                              handler = *contiguous.callback_handler();
+        INFO(input << " split at " << split);
+        for (auto const& part : {input.substr(0, split), input.substr(split)})
+        {
+            std::string buffer = part;  // overwritten once parsed, so spilled parts must not refer to it
+            handler.input      = buffer;
+            REQUIRE(fragmented.parse_bytes(part));
+            REQUIRE(contiguous.parse_bytes(buffer));
+            buffer.assign(buffer.size(), '#');
+        }
+        REQUIRE(handler.fragments == 0);
+        REQUIRE_THAT(handler.calls, Catch::Matchers::Equals(fragmented.callback_handler()->calls));
+    }
+}
+
+TEST_CASE("strings and names spanning input buffers are reported contiguous")
+{
+    std::string const long_text(70, 'x');
+    std::vector<std::string> const inputs = {
+        R"({"name": "value", "esc\"aped": "a\\b\"c", "list": ["one", "", "two"]} )",
+        "{\"" + long_text + "\": [\"" + long_text + "\\\"" + long_text + "\"]} ",
+    };
+    for (auto const& input : inputs)
+    {
+        check_contiguous_strings<contiguous_traits>(input);
+        check_contiguous_strings<indexed_contiguous_traits>(input);
+    }
+
+    // tokens within one input buffer are not copied
+    a::basic_json_parser<contiguous_handler<contiguous_traits>, contiguous_traits> p;
+    std::string const                                                              input = R"({"a": "b", "c": ["d)";
+    p.callback_handler()->input = input;
+    p.parse_bytes(input);
+    REQUIRE(p.callback_handler()->in_place == 3);
+    p.callback_handler()->input = "e\"]} ";
+    p.parse_bytes(p.callback_handler()->input);
+    REQUIRE(p.callback_handler()->in_place == 3);
+    REQUIRE(p.callback_handler()->calls.at(5) == call{call_type::string_value, 0, "de"});
+}
+
+template <typename Traits>
+void check_decoded(std::string const& input, std::vector<call> const& expected)
+{
+    for (size_t split = 0; split <= input.size(); ++split)
+    {
+        a::basic_json_parser<test_handler<Traits>, Traits> p;
+        INFO(input << " split at " << split);
+        REQUIRE(p.parse_bytes(std::string_view(input).substr(0, split)));
+        REQUIRE(p.parse_bytes(std::string_view(input).substr(split)));
+        REQUIRE_THAT(p.callback_handler()->calls, Catch::Matchers::Equals(expected));
+    }
+}
+
+TEST_CASE("escape sequences decoded while parsing")
+{
+    std::string const input =
+        R"({"na\"me": "a\\b\nc\/d\u00e9\uD834\uDD20 end", "plain": "text", "u": ["\u0041\u00DF\u20AC", "\t\f\b\r"]} )";
+    std::vector<call> const expected{{call_type::object_start},
+                                     {call_type::named_object, 0, "na\"me"},
+                                     {call_type::string_value, 0, "a\\b\nc/d\xC3\xA9\xF0\x9D\x84\xA0 end"},
+                                     {call_type::named_object, 0, "plain"},
+                                     {call_type::string_value, 0, "text"},
+                                     {call_type::named_object, 0, "u"},
+                                     {call_type::array_start},
+                                     {call_type::string_value, 0, "A\xC3\x9F\xE2\x82\xAC"},
+                                     {call_type::string_value, 0, "\t\f\b\r"},
+                                     {call_type::array_end},
+                                     {call_type::object_end}};
+    check_decoded<decoding_traits<a::default_traits>>(input, expected);
+    check_decoded<decoding_traits<indexed_traits>>(input, expected);
+    check_decoded<decoding_traits<contiguous_traits>>(input, expected);
+
+    // malformed escapes and unpaired surrogates are passed through
+    check_decoded<decoding_traits<a::default_traits>>(R"(["\q\uD834x\uDD20\u12G4\uD834A"] )",
+                                                      {{call_type::array_start},
+                                                       {call_type::string_value, 0, R"(\q\uD834x\uDD20\u12G4\uD834A)"},
+                                                       {call_type::array_end}});
+
+    // strings without escapes are reported from the input buffer
+    std::string const plain = R"(["text", "esc\\aped"] )";
+    a::basic_json_parser<contiguous_handler<decoding_traits<contiguous_traits>>, decoding_traits<contiguous_traits>> p;
+    p.callback_handler()->input = plain;
+    p.parse_bytes(plain);
+    REQUIRE(p.callback_handler()->in_place == 1);
+    REQUIRE(p.callback_handler()->calls.at(2) == call{call_type::string_value, 0, "esc\\aped"});
+}
@@ -0,0 +1,88 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <string>
+#include <vector>
+#include <async_json/json_validator.hpp>
+#include "catch.hpp"
+
+namespace a = async_json;
+
+namespace
+{
+std::vector<std::string> const valid_documents = {
+    "{}",
+    " [ ] ",
+    "0",
+    "-0.5e+10",
+    "12 ",
+    R"("text \" with \\ escapes \/ \b\f\n\r\t ä😀")",
+    R"({"a": [1, -2.5, 3e-7, 0.0E1], "b": {"c": null, "d": true, "e": false}, "": ""})",
+    "[[[[[]]]], {\"x\": [{}]}]",
+    "\t{\r\n\"k\" :\"v\"\n}\n",
+};
+
+std::vector<std::string> const invalid_documents = {
+    "",
+    "{",
+    "[1,]",
+    "{\"a\" 1}",
+    "{\"a\": 1,}",
+    "{1: 2}",
+    "[1 2]",
+    "01",
+    "- 1",
+    "1.",
+    ".5",
+    "1e",
+    "+1",
+    "[tru]",
+    "nul",
+    "\"unterminated",
+    "\"tab\tinside\"",
+    R"("bad \x escape")",
+    R"("\u12G4")",
+    "{\"a\": 1]",
+    "[1}",
+    "[] []",
+    "[1,\b2]",
+};
+}  // namespace
+
+TEST_CASE("validator accepts valid documents")
+{
+    for (auto const& doc : valid_documents)
+    {
+        INFO(doc);
+        REQUIRE(a::validate(doc));
+    }
+}
+
+TEST_CASE("validator rejects invalid documents")
+{
+    for (auto const& doc : invalid_documents)
+    {
+        INFO(doc);
+        REQUIRE_FALSE(a::validate(doc));
+    }
+}
+
+TEST_CASE("validator across input buffers")
+{
+    std::string const long_text(100, 'x');
+    std::string const doc = R"({"long": ")" + long_text + R"(\"", "list": [1, 2.5e3, true, null, "A"]} )";
+    for (size_t split = 0; split <= doc.size(); ++split)
+    {
+        INFO("split at " << split);
+        a::json_validator validator;
+        REQUIRE(validator.parse_bytes(std::string_view(doc).substr(0, split)));
+        REQUIRE(validator.parse_bytes(std::string_view(doc).substr(split)));
+        REQUIRE(validator.complete());
+    }
+
+    a::json_validator validator;
+    REQUIRE(validator.parse_bytes("[1, 2"));
+    REQUIRE_FALSE(validator.complete());
+    REQUIRE_FALSE(validator.parse_bytes(",]"));
+    validator.reset();
+    REQUIRE(validator.parse_bytes("[\"ok\"]"));
+    REQUIRE(validator.complete());
+}
@@ -0,0 +1,130 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <iostream>
+#include <vector>
+#include <async_json/json_extractor.hpp>
+#include <async_json/path_compiler.hpp>
+#include "catch.hpp"
+
+namespace a = async_json;
+using namespace std::literals;
+
+namespace
+{
+auto report_error = [](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; };
+}
+
+TEST_CASE("JSON Pointer: tokens")
+{
+    auto p = a::compile_json_pointer("/a~1b/m~0n/0/01/-");
+    REQUIRE(p);
+    REQUIRE(p->size() == 5);
+    auto it = p->begin();
+    REQUIRE(it[0].str == "a/b");
+    REQUIRE(it[1].str == "m~n");
+    REQUIRE(it[2].str == "0");
+    REQUIRE(it[2].first == 0);
+    REQUIRE(it[2].last == 1);
+    REQUIRE(it[3].str == "01");
+    REQUIRE(it[3].first == it[3].last);
+    REQUIRE(it[4].str == "-");
+
+    REQUIRE(a::compile_json_pointer("")->empty());
+    REQUIRE(a::compile_json_pointer("/")->size() == 1);
+    REQUIRE_FALSE(a::compile_json_pointer("a/b"));
+    REQUIRE_FALSE(a::compile_json_pointer("/a~2"));
+    REQUIRE_FALSE(a::compile_json_pointer("/a~"));
+}
+
+TEST_CASE("JSONPath: supported subset")
+{
+    auto p = a::compile_json_path("$.store['book shop'][\"it\\\"s\"][*].price[2][1:3][:]");
+    REQUIRE(p);
+    REQUIRE(p->size() == 8);
+    auto it = p->begin();
+    REQUIRE(it[0].str == "store");
+    REQUIRE(it[1].str == "book shop");
+    REQUIRE(it[2].str == "it\"s");
+    REQUIRE(it[3].type == a::detail::path_type::arbitrary);
+    REQUIRE(it[4].str == "price");
+    REQUIRE(it[5].type == a::detail::path_type::elements);
+    REQUIRE(it[5].first == 2);
+    REQUIRE(it[5].last == 3);
+    REQUIRE(it[6].first == 1);
+    REQUIRE(it[6].last == 3);
+    REQUIRE(it[7].first == 0);
+    REQUIRE(it[7].last == ~size_t{0});
+
+    REQUIRE(a::compile_json_path("$")->empty());
+    REQUIRE_FALSE(a::compile_json_path(""));
+    REQUIRE_FALSE(a::compile_json_path("a.b"));
+    REQUIRE_FALSE(a::compile_json_path("$."));
+    REQUIRE_FALSE(a::compile_json_path("$[a]"));
+    REQUIRE_FALSE(a::compile_json_path("$['a'"));
+    REQUIRE_FALSE(a::compile_json_path("$[1"));
+    REQUIRE_FALSE(a::compile_json_path("$[-1]"));
+    REQUIRE_FALSE(a::compile_json_path("$[?(@.a)]"));
+}
+
+TEST_CASE("JSONPath: recursive descent")
+{
+    auto p = a::compile_json_path("$..id..*..['x'][0]");
+    REQUIRE(p);
+    REQUIRE(p->size() == 7);
+    auto it = p->begin();
+    REQUIRE(it[0].type == a::detail::path_type::descendants);
+    REQUIRE(it[1].str == "id");
+    REQUIRE(it[2].type == a::detail::path_type::descendants);
+    REQUIRE(it[3].type == a::detail::path_type::arbitrary);
+    REQUIRE(it[4].type == a::detail::path_type::descendants);
+    REQUIRE(it[5].str == "x");
+    REQUIRE(it[6].first == 0);
+    REQUIRE_FALSE(a::compile_json_path("$.."));
+    REQUIRE_FALSE(a::compile_json_path("$...a"));
+
+    std::vector<long> ids;
+    auto              extractor = a::make_extractor(report_error, a::path([&](auto const& ev) { ids.push_back(ev.as_number()); },
+                                                                          *a::compile_json_path("$..trace_id")));
+    extractor.parse_bytes(R"([{"trace_id":1},{"e":{"trace_id":2}}] )"sv);
+    REQUIRE(ids == std::vector<long>{1, 2});
+}
+
+TEST_CASE("JSON Pointer: array indices and member names")
+{
+    auto const pointer = *a::compile_json_pointer("/a/0/b");
+    long       value   = 0;
+    {
+        auto extractor = a::make_extractor(report_error, a::path(a::assign_numeric(value), pointer));
+        extractor.parse_bytes(R"({"a":[{"b":1},{"b":2}]} )"sv);
+        REQUIRE(value == 1);
+    }
+    {
+        auto extractor = a::make_extractor(report_error, a::path(a::assign_numeric(value), pointer));
+        extractor.parse_bytes(R"({"a":{"1":{"b":4},"0":{"b":3}}} )"sv);
+        REQUIRE(value == 3);
+    }
+}
+
+TEST_CASE("JSONPath: compiled paths next to literal paths")
+{
+    std::string_view const doc = R"({"items":[{"id":1,"name":"x"},{"id":2,"name":"y"},{"id":3,"name":"z"}],"meta":{"count":3}} )";
+    auto const             ids = *a::compile_json_path("$.items[*].id");
+    std::vector<long>      found;
+    std::vector<std::string> names;
+    long                   count = 0;
+    for (int run = 0; run != 2; ++run)
+    {
+        found.clear();
+        names.clear();
+        auto extractor = a::make_extractor(report_error, a::path([&](auto const& ev) { found.push_back(ev.as_number()); }, ids),
+                                           a::path(
+                                               [&](auto const& ev) {
+                                                   if (ev.event == a::saj_event::string_value_start) names.emplace_back(ev.as_string_view());
+                                               },
+                                               *a::compile_json_path("$['items'][1:]['name']")),
+                                           a::path(a::assign_numeric(count), "meta", "count"));
+        extractor.parse_bytes(doc);
+        REQUIRE(found == std::vector<long>{1, 2, 3});
+        REQUIRE(names == std::vector<std::string>{"y", "z"});
+        REQUIRE(count == 3);
+    }
+}
@@ -0,0 +1,106 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <string>
+#include <vector>
+#include <async_json/basic_json_parser.hpp>
+#include <async_json/saj_event_batcher.hpp>
+#include "catch.hpp"
+
+namespace a = async_json;
+
+namespace
+{
+template <typename Traits = a::default_traits>
+struct recorder : a::saj_event_batcher<recorder<Traits>, Traits, 4>
+{
+    std::vector<size_t>      batch_sizes;
+    std::vector<std::string> events;
+
+    void handle_batch(a::saj_event_batch<Traits> const& batch)
+    {
+        batch_sizes.push_back(batch.size());
+        for (auto const& ev : batch)
+        {
+            switch (ev.event)
+            {
+                case a::saj_event::integer_value: events.push_back(std::to_string(ev.as_number())); break;
+                case a::saj_event::number_value: events.emplace_back(ev.as_string_view()); break;
+                case a::saj_event::boolean_value: events.push_back(ev.as_bool() ? "true" : "false"); break;
+                case a::saj_event::null_value: events.push_back("null"); break;
+                case a::saj_event::object_start: events.push_back("{"); break;
+                case a::saj_event::object_end: events.push_back("}"); break;
+                case a::saj_event::array_start: events.push_back("["); break;
+                case a::saj_event::array_end: events.push_back("]"); break;
+                case a::saj_event::object_name_start:
+                case a::saj_event::string_value_start: events.emplace_back(ev.as_string_view()); break;
+                case a::saj_event::object_name_cont:
+                case a::saj_event::string_value_cont: events.back() += ev.as_string_view(); break;
+                case a::saj_event::parse_error: events.push_back("error"); break;
+                default: break;
+            }
+        }
+    }
+};
+}  // namespace
+
+TEST_CASE("batcher: events are delivered in batches")
+{
+    using namespace std::literals;
+    a::basic_json_parser<recorder<>> p;
+    p.parse_bytes(R"({"a": [1, 2, 3, true, null], "b": "text"} )"sv);
+    REQUIRE(p.callback_handler()->events == std::vector<std::string>{"{", "a", "[", "1", "2", "3", "true", "null", "]", "b", "text", "}"});
+    // names and strings are recorded as start and end events
+    REQUIRE(p.callback_handler()->batch_sizes == std::vector<size_t>{4, 4, 4, 3});
+}
+
+TEST_CASE("batcher: batches are flushed at the end of every input buffer")
+{
+    using namespace std::literals;
+    a::basic_json_parser<recorder<>> p;
+    std::string                    first = R"({"na)";
+    p.parse_bytes(first);
+    first.assign(first.size(), '#');  // views into the first buffer must not be used after parse_bytes returned
+    p.parse_bytes(R"(me": "va)"sv);
+    p.parse_bytes(R"(lue", "x": 1} )"sv);
+    REQUIRE(p.callback_handler()->events == std::vector<std::string>{"{", "name", "value", "x", "1", "}"});
+    REQUIRE(p.callback_handler()->batch_sizes.size() == 4);
+}
+
+struct decode_traits : a::default_traits
+{
+    static constexpr bool decode_escapes = true;
+};
+
+TEST_CASE("batcher: decoded strings stay valid until their batch is handled")
+{
+    using namespace std::literals;
+    a::basic_json_parser<recorder<decode_traits>, decode_traits> p;
+    // the parser decodes every escaped string into the same buffer, each batch holds two of them
+    p.parse_bytes(R"({"a\"b": "c\nd", "e\\": "\u00e4", "g": ["\th", "i\""]} )"sv);
+    REQUIRE(p.callback_handler()->events ==
+            std::vector<std::string>{"{", "a\"b", "c\nd", "e\\", "\xc3\xa4", "g", "[", "\th", "i\"", "]", "}"});
+}
+
+struct raw_number_traits : a::default_traits
+{
+    static constexpr bool raw_numbers = true;
+};
+
+struct raw_overflow_traits : a::default_traits
+{
+    static constexpr a::overflow_policy integer_overflow_policy = a::overflow_policy::raw_text;
+};
+
+TEST_CASE("batcher: number texts are recorded")
+{
+    using namespace std::literals;
+    a::basic_json_parser<recorder<raw_number_traits>, raw_number_traits> p;
+    // numbers that span input buffers are joined in a buffer of the parser
+    p.parse_bytes("[12"sv);
+    p.parse_bytes("3, -4.5e1, 6"sv);
+    p.parse_bytes("7] "sv);
+    REQUIRE(p.callback_handler()->events == std::vector<std::string>{"[", "123", "-4.5e1", "67", "]"});
+
+    a::basic_json_parser<recorder<raw_overflow_traits>, raw_overflow_traits> q;
+    q.parse_bytes("[18446744073709551616, 1, -18446744073709551617] "sv);
+    REQUIRE(q.callback_handler()->events == std::vector<std::string>{"[", "18446744073709551616", "1", "-18446744073709551617", "]"});
+}
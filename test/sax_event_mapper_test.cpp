@@ -48,3 +48,19 @@ TEST_CASE("SajEventMapper: test")
     p.parse_bytes(R"( { "you": 123, "a": {} }  )"sv);
 }
 
+
+TEST_CASE("saj_event_value: compact trivially copyable layout")
+{
+    using namespace std::literals;
+    using ev_t = a::saj_event_value<a::default_traits>;
+    static_assert(sizeof(ev_t) == 16);
+    static_assert(std::is_trivially_copyable_v<ev_t>);
+
+    auto const text = "some text"sv;
+    REQUIRE(ev_t(a::saj_event::string_value_start, text).as_string_view() == text);
+    REQUIRE(ev_t(a::saj_event::integer_value, -12L).as_number() == -12);
+    REQUIRE(ev_t(a::saj_event::float_value, 2.5).as_float_number() == 2.5);
+    REQUIRE(ev_t(a::saj_event::boolean_value, true).as_bool());
+    REQUIRE(ev_t(a::saj_event::parse_error, a::invalid_number).as_error_cause() == a::invalid_number);
+    REQUIRE(ev_t(a::saj_event::parse_error, a::invalid_number).value_type() == a::saj_variant_value::error);
+}
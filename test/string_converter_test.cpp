@@ -19,6 +19,69 @@ TEST_CASE("StringConverter: json_to_utf8")
     REQUIRE_THAT(a::json_to_utf8("a\\bnc"), Equals("a\bnc"));
     REQUIRE_THAT(a::json_to_utf8(" \\t "), Equals(" \t "));
     REQUIRE_THAT(a::json_to_utf8("abc def"), Equals("abc def"));
-    REQUIRE_THAT(a::json_to_utf8("abc\\ud834\\udd20def"), Equals("abc㠴㌠def"));
+    REQUIRE_THAT(a::json_to_utf8("abc\\ud834\\udd20def"), Equals("abc\xF0\x9D\x84\xA0" "def"));
+    REQUIRE_THAT(a::json_to_utf8("\\u00e9\\u00C9"), Equals("\xC3\xA9\xC3\x89"));
 }
 
+TEST_CASE("StringConverter: json_to_utf8 in one pass")
+{
+    using Catch::Matchers::Equals;
+    REQUIRE_THAT(a::json_to_utf8("\\/\\f\\u0041"), Equals("/\fA"));
+    // malformed sequences are kept, the rest of the string is still decoded
+    REQUIRE_THAT(a::json_to_utf8("\\q\\n\\uD834\\n\\u12\\n\\uDD20\\"), Equals("\\q\n\\uD834\n\\u12\n\\uDD20\\"));
+
+    std::string path, escaped_path, document, escaped_document;
+    for (int i = 0; i != 1000; ++i)
+    {
+        path += "C:\\dir\\file" + std::to_string(i);
+        escaped_path += "C:\\\\dir\\\\file" + std::to_string(i);
+        document += R"({"key":"value"})";
+        escaped_document += R"({\"key\":\"value\"})";
+    }
+    std::string in_place = escaped_path;
+    REQUIRE(&a::json_to_utf8(in_place) == &in_place);
+    REQUIRE(in_place == path);
+    REQUIRE(a::json_to_utf8(escaped_document) == document);
+
+    std::string out = "prefix ";
+    a::json_to_utf8(std::string_view("a\\tb"), out);
+    REQUIRE_THAT(out, Equals("prefix a\tb"));
+}
+
+TEST_CASE("StringConverter: json_unescaper decodes fragments")
+{
+    std::string const escaped = R"(a\"b\\c\/d\n\u00e9\u20AC\uD834\uDD20 \u12G4\q\uDD20x\uD834A end\uD834)";
+    std::string const decoded = a::json_to_utf8(escaped);
+    REQUIRE(decoded == "a\"b\\c/d\n\xC3\xA9\xE2\x82\xAC\xF0\x9D\x84\xA0 \\u12G4\\q\\uDD20x\\uD834A end\\uD834");
+    std::string       out;
+    auto              unescaper = a::make_json_unescaper([&out](char const* data, size_t size) { out.append(data, size); });
+    for (size_t first = 0; first <= escaped.size(); ++first)
+        for (size_t second = first; second <= escaped.size(); ++second)
+        {
+            INFO("fragments end at " << first << " and " << second);
+            out.clear();
+            unescaper.feed(std::string_view(escaped).substr(0, first));
+            unescaper.feed(std::string_view(escaped).substr(first, second - first));
+            unescaper.feed(std::string_view(escaped).substr(second));
+            unescaper.finish();
+            REQUIRE(out == decoded);
+        }
+
+    out.clear();
+    for (char c : escaped) unescaper.feed(std::string_view(&c, 1));
+    unescaper.finish();
+    REQUIRE(out == decoded);
+
+    // decoded text is passed on while the string still arrives
+    out.clear();
+    unescaper.feed(R"(abc\u12)");
+    REQUIRE(out == "abc");
+    unescaper.feed("34");
+    REQUIRE(out == "abc\xE1\x88\xB4");
+    unescaper.feed(R"(\uD834)");
+    REQUIRE(out == "abc\xE1\x88\xB4");
+    unescaper.reset();
+    unescaper.feed("x");
+    unescaper.finish();
+    REQUIRE(out == "abc\xE1\x88\xB4x");
+}
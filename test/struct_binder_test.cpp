@@ -0,0 +1,125 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <iostream>
+#include <string>
+#include <vector>
+#include <async_json/struct_binder.hpp>
+#include "catch.hpp"
+
+namespace a = async_json;
+using namespace std::literals;
+
+namespace
+{
+struct position
+{
+    double lat{0};
+    double lon{0};
+};
+
+struct message
+{
+    long                     id{0};
+    std::string              name;
+    bool                     active{false};
+    position                 where;
+    std::vector<long>        values;
+    std::vector<std::string> tags;
+};
+}  // namespace
+
+template <>
+struct async_json::json_fields<position>
+{
+    static constexpr auto value = fields(field("lat", &position::lat), field("lon", &position::lon));
+};
+
+template <>
+struct async_json::json_fields<message>
+{
+    static constexpr auto value = fields(field("id", &message::id), field("name", &message::name), field("active", &message::active),
+                                         field("where", &message::where), field("values", &message::values), field("tags", &message::tags));
+};
+
+namespace
+{
+constexpr std::string_view document =
+    R"({"id":42,"unknown":{"id":7,"where":{"lat":9}},"name":"sensor \"7\"","where":{"alt":3,"lat":48.2,"lon":16.4},)"
+    R"("skip":[1,{"name":"x"}],"active":true,"values":[1,2,3],"tags":["a","b"],"extra":null} )";
+}
+
+TEST_CASE("Struct binder: fills nested structs and skips unknown members")
+{
+    message m;
+    int     mismatches = 0;
+    auto    parser     = a::make_struct_parser(m, [&] { ++mismatches; });
+    REQUIRE(parser.parse_bytes(document));
+    REQUIRE(m.id == 42);
+    REQUIRE(m.name == R"(sensor \"7\")");
+    REQUIRE(m.active);
+    REQUIRE(m.where.lat == 48.2);
+    REQUIRE(m.where.lon == 16.4);
+    REQUIRE(m.values == std::vector<long>{1, 2, 3});
+    REQUIRE(m.tags == std::vector<std::string>{"a", "b"});
+    REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("Struct binder: names and values split across input buffers")
+{
+    for (size_t split = 1; split != document.size(); ++split)
+    {
+        message m;
+        auto    parser = a::make_struct_parser(m, [] {});
+        parser.parse_bytes(document.substr(0, split));
+        parser.parse_bytes(document.substr(split));
+        REQUIRE(m.id == 42);
+        REQUIRE(m.name == R"(sensor \"7\")");
+        REQUIRE(m.where.lon == 16.4);
+        REQUIRE(m.tags == std::vector<std::string>{"a", "b"});
+    }
+}
+
+TEST_CASE("Struct binder: values that do not fit their field")
+{
+    message m;
+    int     mismatches = 0;
+    auto    parser     = a::make_struct_parser(m, [&] { ++mismatches; });
+    parser.parse_bytes(R"({"id":"no number","where":5,"name":null,"active":true} )"sv);
+    REQUIRE(mismatches > 0);
+    REQUIRE(m.id == 0);
+    REQUIRE(m.name.empty());
+    REQUIRE(m.active);
+}
+
+TEST_CASE("Struct binder: object or array in place of a scalar field")
+{
+    constexpr auto json = R"({"id":{"x":5,"y":[6]},"name":["a","b"],"active":[true],"values":[7]} )"sv;
+    for (size_t split = 1; split != json.size(); ++split)
+    {
+        message m;
+        int     mismatches = 0;
+        auto    parser     = a::make_struct_parser(m, [&] { ++mismatches; });
+        REQUIRE(parser.parse_bytes(json.substr(0, split)));
+        REQUIRE(parser.parse_bytes(json.substr(split)));
+        REQUIRE(mismatches == 3);
+        REQUIRE(m.id == 0);
+        REQUIRE(m.name.empty());
+        REQUIRE_FALSE(m.active);
+        REQUIRE(m.values == std::vector<long>{7});
+    }
+}
+
+TEST_CASE("Struct binder: bound struct as path action")
+{
+    std::vector<position> positions;
+    position              current;
+    auto                  extractor = a::make_extractor(
+        [](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; },
+        a::path(a::bind(current), "track", a::each),
+        a::path([&](auto const& ev) { if (ev.event == a::saj_event::object_end) positions.push_back(current); }, "track", a::each));
+    extractor.parse_bytes(R"({"track":[{"lat":1,"lon":2},{"lon":4,"lat":3,"speed":9}]} )"sv);
+    REQUIRE(positions.size() == 2);
+    REQUIRE(positions[0].lat == 1);
+    REQUIRE(positions[0].lon == 2);
+    REQUIRE(positions[1].lat == 3);
+    REQUIRE(positions[1].lon == 4);
+}
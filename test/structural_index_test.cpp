@@ -0,0 +1,52 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <string>
+#include <async_json/structural_index.hpp>
+#include "catch.hpp"
+
+namespace a = async_json;
+
+namespace
+{
+std::string block(std::string text)
+{
+    text.resize(64, ' ');
+    return text;
+}
+
+std::string selected_bytes(std::string const& text, uint64_t mask)
+{
+    std::string ret;
+    for (size_t i = 0; i != text.size(); ++i)
+        if (mask & (uint64_t{1} << i)) ret.push_back(text[i]);
+    return ret;
+}
+}  // namespace
+
+TEST_CASE("structural scanner: skips string content and whitespace")
+{
+    auto const                 input = block(R"({ "key" : [ 12 , true ], "v": "a b" })");
+    a::detail::structural_scanner scanner;
+    REQUIRE(selected_bytes(input, scanner.next(input.data())) == R"({"":[12 ,true ],"":""})");
+    REQUIRE_FALSE(scanner.in_string);
+}
+
+TEST_CASE("structural scanner: escapes")
+{
+    auto const                 input = block(R"(["a\"b", "c\\", "\\\"d"])");
+    a::detail::structural_scanner scanner;
+    REQUIRE(selected_bytes(input, scanner.next(input.data())) == R"(["\"","\\","\\\""])");
+}
+
+TEST_CASE("structural scanner: state carried across blocks")
+{
+    auto const first  = std::string(62, ' ') + "\"\\";
+    auto       second = block(R"("x" ,)");
+    second.back()     = '1';
+    a::detail::structural_scanner scanner;
+    REQUIRE(selected_bytes(first, scanner.next(first.data())) == "\"\\");
+    REQUIRE(scanner.in_string);
+    REQUIRE(scanner.escaped);
+    REQUIRE(selected_bytes(second, scanner.next(second.data())) == "\"\",1");
+    REQUIRE_FALSE(scanner.in_string);
+    REQUIRE(scanner.after_scalar);
+}
@@ -0,0 +1,171 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#include <array>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <async_json/struct_binder.hpp>
+#include "catch.hpp"
+
+namespace a = async_json;
+using namespace std::literals;
+
+namespace
+{
+/// user container that records the capacity it was asked to reserve
+struct ring
+{
+    std::vector<int> items;
+    size_t           reserved{0};
+};
+
+struct point
+{
+    int x{0};
+    int y{0};
+};
+
+struct document
+{
+    std::map<std::string, long>                     counts;
+    std::unordered_map<std::string, point>          places;
+    std::optional<long>                             limit;
+    std::optional<std::string>                      label{"unset"};
+    std::array<double, 3>                           rgb{};
+    std::vector<std::vector<int>>                   matrix;
+    std::vector<point>                              points;
+    std::vector<std::optional<int>>                 sparse;
+    ring                                            samples;
+    std::map<std::string, std::vector<std::string>> groups;
+};
+
+struct tagged
+{
+    std::vector<std::string> tags;
+    std::string              name;
+};
+}  // namespace
+
+template <>
+struct async_json::container_traits<ring>
+{
+    using value_type = int;
+    static void reserve(ring& r, size_t capacity) { r.reserved = capacity; }
+    static int& append(ring& r) { return r.items.emplace_back(); }
+};
+
+template <>
+struct async_json::json_fields<point>
+{
+    static constexpr auto value = fields(field("x", &point::x), field("y", &point::y));
+};
+
+template <>
+struct async_json::json_fields<document>
+{
+    static constexpr auto value =
+        fields(field("counts", &document::counts), field("places", &document::places, 64), field("limit", &document::limit),
+               field("label", &document::label), field("rgb", &document::rgb), field("matrix", &document::matrix, 16),
+               field("points", &document::points, 1000), field("sparse", &document::sparse), field("samples", &document::samples, 4096),
+               field("groups", &document::groups));
+};
+
+template <>
+struct async_json::json_fields<tagged>
+{
+    static constexpr auto value = fields(field("tags", &tagged::tags), field("name", &tagged::name));
+};
+
+namespace
+{
+constexpr std::string_view input = R"({"counts":{"a":1,"b":2,"a":3},"places":{"home":{"x":1,"y":2},"work":{"y":4}},"limit":10,)"
+                                   R"("label":null,"rgb":[0.5,1,0.25],"matrix":[[1,2],[],[3]],"points":[{"x":5},{"y":6,"x":7}],)"
+                                   R"("sparse":[1,null,3],"samples":[9,8],"groups":{"g":["x","y"],"h":[]}} )";
+}
+
+TEST_CASE("Value handler: maps, optionals, arrays and nested containers")
+{
+    document d;
+    int      mismatches = 0;
+    auto     parser     = a::make_struct_parser(d, [&] { ++mismatches; });
+    REQUIRE(parser.parse_bytes(input));
+    REQUIRE(mismatches == 0);
+    REQUIRE(d.counts == std::map<std::string, long>{{"a", 3}, {"b", 2}});
+    REQUIRE(d.places.size() == 2);
+    REQUIRE(d.places["home"].x == 1);
+    REQUIRE(d.places["home"].y == 2);
+    REQUIRE(d.places["work"].x == 0);
+    REQUIRE(d.places["work"].y == 4);
+    REQUIRE(d.limit == 10);
+    REQUIRE_FALSE(d.label);
+    REQUIRE(d.rgb == std::array<double, 3>{0.5, 1, 0.25});
+    REQUIRE(d.matrix == std::vector<std::vector<int>>{{1, 2}, {}, {3}});
+    REQUIRE(d.matrix.capacity() >= 16);
+    REQUIRE(d.points.size() == 2);
+    REQUIRE(d.points[0].x == 5);
+    REQUIRE(d.points[1].x == 7);
+    REQUIRE(d.points[1].y == 6);
+    REQUIRE(d.points.capacity() >= 1000);
+    REQUIRE(d.sparse == std::vector<std::optional<int>>{1, std::nullopt, 3});
+    REQUIRE(d.samples.items == std::vector<int>{9, 8});
+    REQUIRE(d.samples.reserved == 4096);
+    REQUIRE(d.groups["g"] == std::vector<std::string>{"x", "y"});
+    REQUIRE(d.groups["h"].empty());
+}
+
+TEST_CASE("Value handler: containers split across input buffers")
+{
+    for (size_t split = 1; split != input.size(); ++split)
+    {
+        document d;
+        auto     parser = a::make_struct_parser(d, [] {});
+        parser.parse_bytes(input.substr(0, split));
+        parser.parse_bytes(input.substr(split));
+        REQUIRE(d.counts.size() == 2);
+        REQUIRE(d.places["home"].y == 2);
+        REQUIRE(d.matrix == std::vector<std::vector<int>>{{1, 2}, {}, {3}});
+        REQUIRE(d.groups["g"] == std::vector<std::string>{"x", "y"});
+    }
+}
+
+TEST_CASE("Value handler: mismatched containers")
+{
+    document d;
+    int      mismatches = 0;
+    auto     parser     = a::make_struct_parser(d, [&] { ++mismatches; });
+    REQUIRE(parser.parse_bytes(R"({"counts":[1,2],"rgb":[1,2,3,4],"matrix":{"a":[1]},"limit":"x","points":[{"x":1}]} )"sv));
+    REQUIRE(mismatches == 4);
+    REQUIRE(d.counts.empty());
+    REQUIRE(d.rgb == std::array<double, 3>{1, 2, 3});
+    REQUIRE(d.matrix.empty());
+    REQUIRE(d.points.size() == 1);
+}
+
+TEST_CASE("Value handler: containers as path actions")
+{
+    std::vector<std::vector<long>> rows;
+    std::map<std::string, double>  totals;
+    auto extractor = a::make_extractor([](a::error_cause er) { std::cout << "ERROR" << static_cast<int>(er) << " \n"; },
+                                       a::path(a::bind(rows), "rows"), a::path(a::bind(totals), "totals"));
+    extractor.parse_bytes(R"({"rows":[[1,2],[3]],"totals":{"x":1.5,"y":2}} )"sv);
+    REQUIRE(rows == std::vector<std::vector<long>>{{1, 2}, {3}});
+    REQUIRE(totals == std::map<std::string, double>{{"x", 1.5}, {"y", 2}});
+}
+
+TEST_CASE("Value handler: string in place of a vector of strings")
+{
+    constexpr auto json = R"({"tags":"solo","name":"n"} )"sv;
+    for (size_t split = 1; split != json.size(); ++split)
+    {
+        tagged t;
+        int    mismatches = 0;
+        auto   parser     = a::make_struct_parser(t, [&] { ++mismatches; });
+        parser.parse_bytes(json.substr(0, split));
+        parser.parse_bytes(json.substr(split));
+        REQUIRE(mismatches == 1);
+        REQUIRE(t.tags.empty());
+        REQUIRE(t.name == "n");
+    }
+}